@@ -0,0 +1,84 @@
+#pragma once
+
+// Arena monotonic untuk string hasil parsing satu batch (moves, moves_uci,
+// jumlah langkah, ...): store() menyalin ke chunk besar dan mengembalikan
+// view, reset() melepas semuanya sekaligus dalam O(1) dengan menyimpan
+// chunk untuk batch berikutnya. Tidak ada malloc / free per game.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+class StringArena {
+public:
+    explicit StringArena(size_t chunk_bytes = 256 << 10) : chunk_bytes(chunk_bytes) {}
+
+    // arena asal dikosongkan, view lama tetap valid di arena tujuan
+    StringArena(StringArena &&other) noexcept {
+        *this = std::move(other);
+    }
+
+    StringArena &operator=(StringArena &&other) noexcept {
+        chunk_bytes = other.chunk_bytes;
+        chunks = std::move(other.chunks);
+        current = other.current;
+        cursor = other.cursor;
+        remaining = other.remaining;
+        other.chunks.clear();
+        other.reset();
+        return *this;
+    }
+
+    // view valid sampai reset()
+    std::string_view store(std::string_view value) {
+        if (value.size() > remaining) next_chunk(value.size());
+        char *dst = cursor;
+        if (!value.empty()) memcpy(dst, value.data(), value.size());
+        cursor += value.size();
+        remaining -= value.size();
+        return std::string_view(dst, value.size());
+    }
+
+    void reset() {
+        current = 0;
+        cursor = chunks.empty() ? nullptr : chunks[0].data.get();
+        remaining = chunks.empty() ? 0 : chunks[0].size;
+    }
+
+    // total memori chunk, termasuk yang belum terpakai sejak reset
+    size_t capacity() const {
+        size_t total = 0;
+        for (const Chunk &chunk : chunks) total += chunk.size;
+        return total;
+    }
+
+private:
+    struct Chunk {
+        std::unique_ptr<char[]> data;
+        size_t size = 0;
+    };
+
+    size_t chunk_bytes = 256 << 10;
+    std::vector<Chunk> chunks;
+    size_t current = 0;       // chunk yang sedang diisi
+    char *cursor = nullptr;
+    size_t remaining = 0;
+
+    // pindah ke chunk berikutnya yang sudah ada, atau alokasi baru jika
+    // belum ada / terlalu kecil untuk nilai sebesar need
+    void next_chunk(size_t need) {
+        size_t next = chunks.empty() ? 0 : current + 1;
+        if (next >= chunks.size() || chunks[next].size < need) {
+            Chunk chunk;
+            chunk.size = std::max(chunk_bytes, need);
+            chunk.data.reset(new char[chunk.size]);
+            chunks.insert(chunks.begin() + next, std::move(chunk));
+        }
+        current = next;
+        cursor = chunks[current].data.get();
+        remaining = chunks[current].size;
+    }
+};
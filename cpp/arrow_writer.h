@@ -0,0 +1,494 @@
+#pragma once
+
+// Writer Arrow IPC file (Feather v2) tanpa library Arrow: metadata flatbuffer
+// disusun manual, kolom di-buffer per record batch lalu ditulis apa adanya.
+//
+// Baca dari Python tanpa parsing, memory-mapped:
+//   pa.ipc.open_file(pa.memory_map(path)).read_all().to_pandas()
+//   pd.read_feather(path)
+//
+// Kolom string kosong dan angka yang tidak valid ditulis sebagai null.
+// Dictionary ditulis sekali di akhir file (boleh di format file, reader
+// membaca dictionary dari footer).
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+enum class ArrowType {
+    Utf8,        // string, offset int32
+    LargeUtf8,   // string, offset int64 (kolom moves)
+    Dictionary,  // string dengan index int32 ke dictionary
+    Int16,
+};
+
+struct ArrowColumn {
+    std::string_view name;
+    ArrowType type;
+};
+
+// FlatBufferBuilder minimal: buffer disusun dari belakang, offset dihitung dari ujung buffer
+class FlatBuilder {
+public:
+    size_t size() const {
+        return buf.size();
+    }
+
+    void align(size_t alignment, size_t extra = 0) {
+        if (alignment > min_align) min_align = alignment;
+        while ((buf.size() + extra) % alignment) buf.insert(buf.begin(), 0);
+    }
+
+    template <typename T>
+    void prepend(T value) {
+        align(sizeof(T));
+        uint8_t bytes[sizeof(T)];
+        memcpy(bytes, &value, sizeof(T));  // little endian
+        buf.insert(buf.begin(), bytes, bytes + sizeof(T));
+    }
+
+    void prepend_offset(uint32_t offset) {
+        align(4);
+        prepend<uint32_t>((uint32_t)(size() + 4 - offset));
+    }
+
+    uint32_t create_string(std::string_view text) {
+        align(4, text.size() + 1);
+        buf.insert(buf.begin(), 0);
+        buf.insert(buf.begin(), text.begin(), text.end());
+        prepend<uint32_t>((uint32_t)text.size());
+        return (uint32_t)size();
+    }
+
+    uint32_t create_offset_vector(const std::vector<uint32_t> &offsets) {
+        align(4, offsets.size() * 4);
+        for (size_t i = offsets.size(); i-- > 0;) prepend_offset(offsets[i]);
+        prepend<uint32_t>((uint32_t)offsets.size());
+        return (uint32_t)size();
+    }
+
+    // vector struct yang seluruh field-nya int64 (FieldNode, Buffer, Block)
+    uint32_t create_struct_vector(const std::vector<int64_t> &words, size_t words_per_struct) {
+        size_t count = words.size() / words_per_struct;
+        align(4, words.size() * 8);
+        align(8, words.size() * 8);
+        for (size_t i = words.size(); i-- > 0;) prepend<int64_t>(words[i]);
+        prepend<uint32_t>((uint32_t)count);
+        return (uint32_t)size();
+    }
+
+    void start_table() {
+        fields.clear();
+        table_start = size();
+    }
+
+    template <typename T>
+    void add_scalar(uint16_t id, T value) {
+        prepend(value);
+        fields.emplace_back(id, (uint32_t)size());
+    }
+
+    void add_offset(uint16_t id, uint32_t offset) {
+        prepend_offset(offset);
+        fields.emplace_back(id, (uint32_t)size());
+    }
+
+    uint32_t end_table() {
+        prepend<int32_t>(0);  // diisi offset ke vtable
+        uint32_t table = (uint32_t)size();
+
+        uint16_t max_id = 0;
+        for (const auto &field : fields) max_id = std::max<uint16_t>(max_id, field.first + 1);
+
+        std::vector<uint16_t> slots(max_id, 0);
+        for (const auto &field : fields) slots[field.first] = (uint16_t)(table - field.second);
+
+        for (size_t i = slots.size(); i-- > 0;) prepend<uint16_t>(slots[i]);
+        prepend<uint16_t>((uint16_t)(table - table_start));
+        prepend<uint16_t>((uint16_t)(4 + 2 * slots.size()));
+
+        int32_t vtable_distance = (int32_t)(size() - table);
+        memcpy(&buf[buf.size() - table], &vtable_distance, 4);
+        return table;
+    }
+
+    // root table, hasil dipad ke 8 byte
+    std::vector<uint8_t> finish(uint32_t root) {
+        align(std::max<size_t>(min_align, 8), 4);
+        prepend_offset(root);
+        while (buf.size() % 8) buf.push_back(0);
+        return std::move(buf);
+    }
+
+private:
+    std::vector<uint8_t> buf;
+    size_t min_align = 1;
+    size_t table_start = 0;
+    std::vector<std::pair<uint16_t, uint32_t>> fields;
+};
+
+class ArrowWriter {
+public:
+    ArrowWriter(const fs::path &filename, std::vector<ArrowColumn> schema, size_t batch_rows)
+        : columns(schema.size()), batch_rows(batch_rows) {
+        int64_t next_dictionary = 0;
+        for (size_t i = 0; i < schema.size(); ++i) {
+            columns[i].spec = schema[i];
+            if (schema[i].type == ArrowType::Dictionary) columns[i].dictionary_id = next_dictionary++;
+        }
+
+        fout.open(filename, std::ios::binary | std::ios::trunc);
+        if (!fout) {
+            throw std::runtime_error("Cannot open Arrow file");
+        }
+
+        write_bytes("ARROW1\0\0", 8);
+        write_message(MESSAGE_SCHEMA, [&](FlatBuilder &fb) { return build_schema(fb); }, {});
+    }
+
+    ArrowWriter(const ArrowWriter &) = delete;
+    ArrowWriter &operator=(const ArrowWriter &) = delete;
+
+    ~ArrowWriter() {
+        if (!closed) {
+            try {
+                close();
+            } catch (...) {
+            }
+        }
+    }
+
+    size_t rows_written() const {
+        return total_rows;
+    }
+
+    void write_row(const std::string_view *fields, size_t count) {
+        for (size_t i = 0; i < count && i < columns.size(); ++i) {
+            append(columns[i], fields[i]);
+        }
+        if (++rows == batch_rows) write_batch();
+    }
+
+    // tulis sisa row, dictionary, dan footer
+    void close() {
+        if (closed) return;
+        closed = true;
+
+        if (rows > 0) write_batch();
+
+        for (auto &column : columns) {
+            if (column.spec.type != ArrowType::Dictionary) continue;
+            write_dictionary(column);
+        }
+
+        // end-of-stream
+        write_bytes("\xFF\xFF\xFF\xFF\0\0\0\0", 8);
+
+        FlatBuilder fb;
+        uint32_t schema = build_schema(fb);
+        uint32_t dictionaries = fb.create_struct_vector(dictionary_blocks, 3);
+        uint32_t batches = fb.create_struct_vector(batch_blocks, 3);
+        fb.start_table();
+        fb.add_offset(3, batches);
+        fb.add_offset(2, dictionaries);
+        fb.add_offset(1, schema);
+        fb.add_scalar<int16_t>(0, METADATA_V5);
+        std::vector<uint8_t> footer = fb.finish(fb.end_table());
+
+        write_bytes(footer.data(), footer.size());
+        int32_t footer_size = (int32_t)footer.size();
+        write_bytes(&footer_size, 4);
+        write_bytes("ARROW1", 6);
+
+        fout.close();
+        if (!fout) {
+            throw std::runtime_error("Cannot write Arrow file");
+        }
+    }
+
+private:
+    static const int16_t METADATA_V5 = 4;
+    static const uint8_t MESSAGE_SCHEMA = 1;
+    static const uint8_t MESSAGE_DICTIONARY = 2;
+    static const uint8_t MESSAGE_RECORD_BATCH = 3;
+    static const uint8_t TYPE_INT = 2;
+    static const uint8_t TYPE_UTF8 = 5;
+    static const uint8_t TYPE_LARGE_UTF8 = 20;
+
+    struct Column {
+        ArrowColumn spec;
+        int64_t dictionary_id = -1;
+
+        std::vector<uint8_t> validity;  // bit per row, 1 = ada nilai
+        size_t null_count = 0;
+        std::vector<int16_t> int16_values;
+        std::vector<int32_t> indices;   // index dictionary
+        std::vector<int64_t> offsets;   // offset string, ditulis int32 / int64
+        std::string data;
+
+        // nilai dictionary, key menunjuk ke string di values
+        std::deque<std::string> values;
+        std::unordered_map<std::string_view, int32_t> lookup;
+    };
+
+    // buffer body satu message, offset relatif ke awal body
+    struct Body {
+        std::vector<int64_t> nodes;    // (length, null_count)
+        std::vector<int64_t> buffers;  // (offset, length)
+        std::string bytes;
+
+        void add(const void *data, size_t size) {
+            buffers.push_back((int64_t)bytes.size());
+            buffers.push_back((int64_t)size);
+            if (size > 0) bytes.append((const char *)data, size);
+            bytes.append((8 - bytes.size() % 8) % 8, '\0');
+        }
+    };
+
+    std::ofstream fout;
+    uint64_t file_offset = 0;
+    std::vector<Column> columns;
+    size_t batch_rows;
+    size_t rows = 0;
+    size_t total_rows = 0;
+    bool closed = false;
+    std::vector<int64_t> batch_blocks;       // (offset, metadata length, body length)
+    std::vector<int64_t> dictionary_blocks;
+
+    void write_bytes(const void *data, size_t size) {
+        fout.write((const char *)data, size);
+        file_offset += size;
+    }
+
+    static bool parse_int16(std::string_view text, int16_t &value) {
+        size_t i = 0;
+        bool negative = false;
+        if (!text.empty() && (text[0] == '+' || text[0] == '-')) {
+            negative = text[0] == '-';
+            i = 1;
+        }
+        if (i == text.size()) return false;
+
+        int result = 0;
+        for (; i < text.size(); ++i) {
+            if (text[i] < '0' || text[i] > '9') return false;
+            result = result * 10 + (text[i] - '0');
+            if (result > 32767) return false;
+        }
+        value = (int16_t)(negative ? -result : result);
+        return true;
+    }
+
+    void append(Column &column, std::string_view value) {
+        if (rows % 8 == 0) column.validity.push_back(0);
+
+        bool valid = !value.empty();
+        switch (column.spec.type) {
+        case ArrowType::Int16: {
+            int16_t number = 0;
+            valid = valid && parse_int16(value, number);
+            column.int16_values.push_back(valid ? number : 0);
+            break;
+        }
+        case ArrowType::Dictionary: {
+            int32_t index = 0;
+            if (valid) {
+                auto it = column.lookup.find(value);
+                if (it == column.lookup.end()) {
+                    index = (int32_t)column.values.size();
+                    column.values.emplace_back(value);
+                    column.lookup.emplace(column.values.back(), index);
+                } else {
+                    index = it->second;
+                }
+            }
+            column.indices.push_back(index);
+            break;
+        }
+        case ArrowType::Utf8:
+        case ArrowType::LargeUtf8:
+            if (column.offsets.empty()) column.offsets.push_back(0);
+            column.data.append(value);
+            column.offsets.push_back((int64_t)column.data.size());
+            break;
+        }
+
+        if (valid) {
+            column.validity.back() |= 1 << (rows % 8);
+        } else {
+            column.null_count++;
+        }
+    }
+
+    static void add_offsets(Body &body, const std::vector<int64_t> &offsets, bool large) {
+        if (large) {
+            body.add(offsets.data(), offsets.size() * 8);
+            return;
+        }
+        std::vector<int32_t> narrow(offsets.begin(), offsets.end());
+        body.add(narrow.data(), narrow.size() * 4);
+    }
+
+    void write_batch() {
+        Body body;
+        for (auto &column : columns) {
+            body.nodes.push_back((int64_t)rows);
+            body.nodes.push_back((int64_t)column.null_count);
+
+            // validity boleh kosong jika tidak ada null
+            body.add(column.validity.data(), column.null_count ? column.validity.size() : 0);
+
+            switch (column.spec.type) {
+            case ArrowType::Int16:
+                body.add(column.int16_values.data(), column.int16_values.size() * 2);
+                break;
+            case ArrowType::Dictionary:
+                body.add(column.indices.data(), column.indices.size() * 4);
+                break;
+            case ArrowType::Utf8:
+            case ArrowType::LargeUtf8:
+                if (column.data.size() > INT32_MAX && column.spec.type == ArrowType::Utf8) {
+                    throw std::runtime_error("Arrow string column exceeds 2GB in one batch");
+                }
+                add_offsets(body, column.offsets, column.spec.type == ArrowType::LargeUtf8);
+                body.add(column.data.data(), column.data.size());
+                break;
+            }
+
+            column.validity.clear();
+            column.null_count = 0;
+            column.int16_values.clear();
+            column.indices.clear();
+            column.offsets.clear();
+            column.data.clear();
+        }
+
+        int64_t length = (int64_t)rows;
+        write_message(MESSAGE_RECORD_BATCH, [&](FlatBuilder &fb) { return build_record_batch(fb, length, body); },
+                      body, &batch_blocks);
+        total_rows += rows;
+        rows = 0;
+    }
+
+    void write_dictionary(const Column &column) {
+        Body body;
+        std::vector<int64_t> offsets{ 0 };
+        std::string data;
+        for (const auto &value : column.values) {
+            data.append(value);
+            offsets.push_back((int64_t)data.size());
+        }
+
+        body.nodes.push_back((int64_t)column.values.size());
+        body.nodes.push_back(0);
+        body.add(nullptr, 0);
+        add_offsets(body, offsets, false);
+        body.add(data.data(), data.size());
+
+        int64_t length = (int64_t)column.values.size();
+        write_message(MESSAGE_DICTIONARY, [&](FlatBuilder &fb) {
+            uint32_t batch = build_record_batch(fb, length, body);
+            fb.start_table();
+            fb.add_scalar<int64_t>(0, column.dictionary_id);
+            fb.add_offset(1, batch);
+            return fb.end_table();
+        }, body, &dictionary_blocks);
+    }
+
+    // message terenkapsulasi: 0xFFFFFFFF, panjang metadata, flatbuffer Message, body
+    template <typename BuildHeader>
+    void write_message(uint8_t header_type, BuildHeader &&build_header, const Body &body,
+                       std::vector<int64_t> *blocks = nullptr) {
+        FlatBuilder fb;
+        uint32_t header = build_header(fb);
+        fb.start_table();
+        fb.add_scalar<int64_t>(3, (int64_t)body.bytes.size());
+        fb.add_offset(2, header);
+        fb.add_scalar<int16_t>(0, METADATA_V5);
+        fb.add_scalar<uint8_t>(1, header_type);
+        std::vector<uint8_t> metadata = fb.finish(fb.end_table());
+
+        if (blocks) {
+            blocks->push_back((int64_t)file_offset);
+            blocks->push_back((int64_t)(metadata.size() + 8));  // struct Block: int32 + padding
+            blocks->push_back((int64_t)body.bytes.size());
+        }
+
+        uint32_t continuation = 0xFFFFFFFF;
+        int32_t metadata_size = (int32_t)metadata.size();
+        write_bytes(&continuation, 4);
+        write_bytes(&metadata_size, 4);
+        write_bytes(metadata.data(), metadata.size());
+        write_bytes(body.bytes.data(), body.bytes.size());
+    }
+
+    uint32_t build_record_batch(FlatBuilder &fb, int64_t length, const Body &body) {
+        uint32_t nodes = fb.create_struct_vector(body.nodes, 2);
+        uint32_t buffers = fb.create_struct_vector(body.buffers, 2);
+        fb.start_table();
+        fb.add_scalar<int64_t>(0, length);
+        fb.add_offset(1, nodes);
+        fb.add_offset(2, buffers);
+        return fb.end_table();
+    }
+
+    uint32_t build_int_type(FlatBuilder &fb, int32_t bit_width) {
+        fb.start_table();
+        fb.add_scalar<int32_t>(0, bit_width);
+        fb.add_scalar<uint8_t>(1, 1);  // signed
+        return fb.end_table();
+    }
+
+    uint32_t build_schema(FlatBuilder &fb) {
+        std::vector<uint32_t> fields;
+        for (const auto &column : columns) {
+            uint32_t name = fb.create_string(column.spec.name);
+            uint32_t children = fb.create_offset_vector({});
+
+            uint8_t type_type = TYPE_UTF8;
+            uint32_t type;
+            if (column.spec.type == ArrowType::Int16) {
+                type_type = TYPE_INT;
+                type = build_int_type(fb, 16);
+            } else {
+                if (column.spec.type == ArrowType::LargeUtf8) type_type = TYPE_LARGE_UTF8;
+                fb.start_table();  // Utf8 / LargeUtf8 tidak punya field
+                type = fb.end_table();
+            }
+
+            uint32_t dictionary = 0;
+            if (column.spec.type == ArrowType::Dictionary) {
+                uint32_t index_type = build_int_type(fb, 32);
+                fb.start_table();
+                fb.add_scalar<int64_t>(0, column.dictionary_id);
+                fb.add_offset(1, index_type);
+                dictionary = fb.end_table();
+            }
+
+            fb.start_table();
+            fb.add_offset(0, name);
+            fb.add_offset(3, type);
+            if (dictionary) fb.add_offset(4, dictionary);
+            fb.add_offset(5, children);
+            fb.add_scalar<uint8_t>(1, 1);  // nullable
+            fb.add_scalar<uint8_t>(2, type_type);
+            fields.push_back(fb.end_table());
+        }
+
+        uint32_t field_vector = fb.create_offset_vector(fields);
+        fb.start_table();
+        fb.add_offset(1, field_vector);
+        fb.add_scalar<int16_t>(0, 0);  // little endian
+        return fb.end_table();
+    }
+};
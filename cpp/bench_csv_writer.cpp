@@ -0,0 +1,149 @@
+// Micro-benchmark CSVWriter saja (tanpa dekompresi/parsing): row sintetis
+// seukuran game Lichess ditulis berulang, dibandingkan dengan writer lama
+// berbasis std::ofstream. Output kedua writer harus sama persis.
+//
+// g++ -std=c++17 -O2 bench_csv_writer.cpp -o bench_csv_writer
+// ./bench_csv_writer [rows] [output.csv] [--direct-io]
+
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "csv_writer.h"
+
+using namespace std;
+
+static const size_t N_FIELDS = 20;  // jumlah kolom CSV generate_data
+
+// writer lama: string per field, escape dengan insert, tulis lewat ofstream
+void write_row_ofstream(std::ofstream &fout, const std::string_view *fields, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        std::string value(fields[i]);
+
+        size_t pos = 0;
+        while ((pos = value.find('"', pos)) != std::string::npos) {
+            value.insert(pos, "\"");
+            pos += 2;
+        }
+
+        fout << "\"" << value << "\"";
+        if (i + 1 < count) fout << ",";
+    }
+    fout << "\n";
+}
+
+// beberapa row dengan isi berbeda, dipakai bergiliran
+std::vector<std::array<std::string, N_FIELDS>> make_rows(size_t n) {
+    std::mt19937 rng(42);
+    static const char *SAN[] = { "e4", "e5", "Nf3", "Nc6", "Bb5", "a6", "Ba4", "Nf6", "O-O", "Be7", "Re1", "b5", "Qxd8+", "exd5" };
+
+    std::vector<std::array<std::string, N_FIELDS>> rows(n);
+    for (size_t r = 0; r < n; ++r) {
+        auto &row = rows[r];
+        row[0] = "Rated Blitz game";
+        row[1] = "https://lichess.org/" + std::to_string(rng());
+        row[2] = "player_" + std::to_string(rng() % 100000);
+        row[3] = r % 7 == 0 ? "name \"with\" quotes" : "player_" + std::to_string(rng() % 100000);
+        row[4] = "1-0";
+        row[5] = "2025.12.01";
+        row[6] = "12:34:56";
+        row[7] = std::to_string(2200 + rng() % 600);
+        row[8] = std::to_string(2200 + rng() % 600);
+        row[9] = "+5";
+        row[10] = "-5";
+        row[11] = "B20";
+        row[12] = "Normal";
+        row[13] = "180+0";
+        row[14] = "Sicilian Defense";
+        size_t plies = 40 + rng() % 80;
+        for (size_t i = 0; i < plies; ++i) {
+            if (i) row[15] += ' ';
+            row[15] += SAN[rng() % 14];
+        }
+        row[16] = std::to_string(plies / 2);
+        row[17] = std::to_string(plies - plies / 2);
+        row[18] = std::to_string(plies);
+        row[19] = row[15];
+    }
+    return rows;
+}
+
+int main(int argc, char **argv) {
+    size_t n_rows = 1000000;
+    fs::path output = "bench_csv_writer.csv";
+    bool direct_io = false;
+
+    int positional = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--direct-io") {
+            direct_io = true;
+        } else if (positional++ == 0) {
+            n_rows = std::stoull(arg);
+        } else {
+            output = arg;
+        }
+    }
+
+    auto rows = make_rows(1024);
+    std::vector<std::array<std::string_view, N_FIELDS>> views(rows.size());
+    size_t row_bytes = 0;
+    for (size_t r = 0; r < rows.size(); ++r) {
+        for (size_t i = 0; i < N_FIELDS; ++i) {
+            views[r][i] = rows[r][i];
+            row_bytes += rows[r][i].size();
+        }
+    }
+    row_bytes /= rows.size();
+
+    cout << "Rows            : " << n_rows << " (~" << row_bytes << " bytes per row)\n";
+
+    auto report = [&](const char *name, std::chrono::steady_clock::time_point start) {
+        double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double mb = fs::file_size(output) / 1048576.0;
+        cout << name << ": " << (size_t)(n_rows / sec) << " rows/sec, "
+             << (size_t)(mb / sec) << " MB/s (" << sec << " s)\n";
+    };
+
+    fs::path legacy_output = output.string() + ".ofstream";
+    {
+        auto start = std::chrono::steady_clock::now();
+        std::ofstream fout(legacy_output);
+        for (size_t r = 0; r < n_rows; ++r) {
+            write_row_ofstream(fout, views[r % views.size()].data(), N_FIELDS);
+        }
+        fout.close();
+        std::swap(output, legacy_output);
+        report("ofstream        ", start);
+        std::swap(output, legacy_output);
+    }
+
+    {
+        auto start = std::chrono::steady_clock::now();
+        CSVWriter csv(output, 0, direct_io);
+        for (size_t r = 0; r < n_rows; ++r) {
+            csv.write_row(views[r % views.size()].data(), N_FIELDS);
+        }
+        csv.flush();
+        report(csv.direct_io() ? "CSVWriter direct" : "CSVWriter       ", start);
+    }
+
+    // cek output sama persis
+    std::ifstream a(output, std::ios::binary), b(legacy_output, std::ios::binary);
+    bool same = fs::file_size(output) == fs::file_size(legacy_output) &&
+                std::equal(std::istreambuf_iterator<char>(a), std::istreambuf_iterator<char>(),
+                           std::istreambuf_iterator<char>(b));
+    fs::remove(legacy_output);
+    fs::remove(output);
+
+    if (!same) {
+        cerr << "[ERROR] CSVWriter output differs from ofstream output" << endl;
+        return 1;
+    }
+    cout << "Output identical\n";
+    return 0;
+}
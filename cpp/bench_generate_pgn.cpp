@@ -0,0 +1,452 @@
+// Generator korpus PGN sintetis mirip dump Lichess untuk benchmark generate_data.
+// Output deterministik untuk seed yang sama: header lengkap, distribusi Elo,
+// time control, panjang game, komentar [%clk] di semua game ber-clock dan
+// [%eval] di sebagian game, lalu dikompres zstd dalam satu frame seperti dump Lichess.
+// Langkahnya legal (line pembuka lalu langkah legal acak dari chess_board.h),
+// jadi replay / tree di generate_data benar-benar bekerja. Sebagian game tanpa
+// komentar sama sekali ("1. e4 e5 2. Nf3 ..."), seperti game correspondence.
+//
+// keep-rate mengatur fraksi game yang lolos filter generate_data
+// (WhiteElo & BlackElo >= 2200, TimeControl base 180..300 detik).
+//
+// g++ -std=c++17 -O2 bench_generate_pgn.cpp -lzstd -o bench_generate_pgn
+// ./bench_generate_pgn --games 200000 --keep-rate 0.02 --out bench_2pct.pgn.zst
+
+#include <zstd.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "chess_board.h"
+
+using namespace std;
+
+struct GeneratorOptions {
+    size_t games = 200000;
+    double keep_rate = 0.02;
+    unsigned seed = 1;
+    int level = 19;        // level zstd
+    size_t frame_mb = 0;   // > 0: frame zstd baru tiap N MB teks (uji dekompresi paralel)
+    std::string out = "bench.pgn.zst";
+};
+
+struct TimeControl {
+    int base;
+    int increment;
+    const char *speed;
+    double weight;  // kira-kira proporsi di dump Lichess
+};
+
+static const TimeControl TIME_CONTROLS[] = {
+    { 60, 0, "Bullet", 0.22 }, { 120, 1, "Bullet", 0.08 }, { 180, 0, "Blitz", 0.20 }, { 180, 2, "Blitz", 0.12 },
+    { 300, 0, "Blitz", 0.12 }, { 300, 3, "Blitz", 0.08 }, { 600, 0, "Rapid", 0.12 }, { 600, 5, "Rapid", 0.03 },
+    { 900, 10, "Rapid", 0.02 }, { 1800, 0, "Classical", 0.01 },
+};
+static const size_t N_TIME_CONTROLS = sizeof(TIME_CONTROLS) / sizeof(TIME_CONTROLS[0]);
+
+struct Opening {
+    const char *eco;
+    const char *name;
+    std::vector<const char *> line;  // langkah pembuka
+};
+
+static const Opening OPENINGS[] = {
+    { "B20", "Sicilian Defense", { "e4", "c5" } },
+    { "B22", "Sicilian Defense: Alapin Variation", { "e4", "c5", "c3" } },
+    { "C00", "French Defense: Normal Variation", { "e4", "e6", "d4", "d5" } },
+    { "C50", "Italian Game", { "e4", "e5", "Nf3", "Nc6", "Bc4" } },
+    { "C60", "Ruy Lopez", { "e4", "e5", "Nf3", "Nc6", "Bb5" } },
+    { "D02", "Queen's Pawn Game: London System", { "d4", "d5", "Nf3", "Nf6", "Bf4" } },
+    { "D30", "Queen's Gambit Declined", { "d4", "d5", "c4", "e6" } },
+    { "A00", "Van't Kruijs Opening", { "e3" } },
+    { "B01", "Scandinavian Defense", { "e4", "d5" } },
+    { "E60", "King's Indian Defense", { "d4", "Nf6", "c4", "g6" } },
+    { "A45", "Indian Defense", { "d4", "Nf6" } },
+    { "C44", "King's Pawn Game: Tayler Opening", { "e4", "e5", "Nf3", "Nc6", "Be2" } },
+};
+static const size_t N_OPENINGS = sizeof(OPENINGS) / sizeof(OPENINGS[0]);
+
+static const char *TERMINATIONS[] = { "Normal", "Normal", "Normal", "Time forfeit", "Abandoned" };
+static const char *TITLES[] = { "GM", "IM", "FM", "CM", "NM", "BOT", "LM" };
+
+class Corpus {
+public:
+    explicit Corpus(const GeneratorOptions &options) : options(options), rng(options.seed) {}
+
+    void game(std::string &out, size_t index) {
+        bool keep = uniform() < options.keep_rate;
+
+        const TimeControl &tc = keep ? pick_blitz() : pick_time_control();
+        int white_elo = keep ? uniform_int(2200, 2900) : elo();
+        int black_elo = keep ? uniform_int(2200, 2900) : elo();
+
+        // game yang tidak dipilih tidak boleh lolos filter secara kebetulan
+        if (!keep && white_elo >= 2200 && black_elo >= 2200 && tc.base >= 180 && tc.base <= 300) {
+            black_elo = uniform_int(1200, 2199);
+        }
+
+        const Opening &opening = OPENINGS[uniform_int(0, N_OPENINGS - 1)];
+        int result = uniform_int(0, 99);
+        const char *result_text = result < 49 ? "1-0" : result < 94 ? "0-1" : "1/2-1/2";
+        int white_diff = uniform_int(3, 12);
+
+        int plies = (int)std::clamp(normal(72.0, 30.0), 0.0, 300.0);
+        if (uniform() < 0.02) plies = 0;  // abandoned sebelum langkah pertama
+        play(opening, plies, result_text);  // mat / stalemate bisa mengganti result
+        bool white_won = std::strcmp(result_text, "1-0") == 0;
+
+        bool tournament = uniform() < 0.15;
+        append_tag(out, "Event", std::string("Rated ") + tc.speed + (tournament ? " tournament https://lichess.org/tournament/" + id(8) : " game"));
+        append_tag(out, "Site", "https://lichess.org/" + id(8));
+        append_tag(out, "Date", "2025.12." + two_digits(1 + index % 28));
+        append_tag(out, "Round", "-");
+        append_tag(out, "White", player());
+        append_tag(out, "Black", player());
+        append_tag(out, "Result", result_text);
+        append_tag(out, "UTCDate", "2025.12." + two_digits(1 + index % 28));
+        append_tag(out, "UTCTime", two_digits(index / 3600 % 24) + ":" + two_digits(index / 60 % 60) + ":" + two_digits(index % 60));
+        append_tag(out, "WhiteElo", std::to_string(white_elo));
+        append_tag(out, "BlackElo", std::to_string(black_elo));
+        append_tag(out, "WhiteRatingDiff", (white_won ? "+" : "-") + std::to_string(white_diff));
+        append_tag(out, "BlackRatingDiff", (white_won ? "-" : "+") + std::to_string(white_diff));
+        if (uniform() < 0.03) append_tag(out, "WhiteTitle", TITLES[uniform_int(0, 6)]);
+        if (uniform() < 0.03) append_tag(out, "BlackTitle", TITLES[uniform_int(0, 6)]);
+        append_tag(out, "ECO", opening.eco);
+        append_tag(out, "Opening", opening.name);
+        append_tag(out, "TimeControl", std::to_string(tc.base) + "+" + std::to_string(tc.increment));
+        append_tag(out, "Termination", TERMINATIONS[uniform_int(0, 4)]);
+        out += '\n';
+
+        moves(out, tc, result_text);
+        out += "\n\n";
+    }
+
+private:
+    const GeneratorOptions &options;
+    std::mt19937_64 rng;
+    std::vector<std::string> sans;           // SAN game yang sedang dibuat
+    std::vector<chess::Move> candidates;     // buffer langkah pseudo-legal
+
+    // distribusi ditulis sendiri: std::*_distribution berbeda antar standard library,
+    // mt19937_64 sendiri sudah ditentukan standar sehingga korpus sama di semua platform
+    double uniform() {
+        return (rng() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    int uniform_int(int lo, int hi) {
+        return lo + (int)(rng() % (uint64_t)(hi - lo + 1));
+    }
+
+    double normal(double mean, double stddev) {
+        double u1 = std::max(uniform(), 1e-300);
+        double u2 = uniform();
+        return mean + stddev * std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+    }
+
+    // rating pool Lichess: kira-kira normal di sekitar 1500
+    int elo() {
+        return (int)std::clamp(normal(1550.0, 380.0), 400.0, 3300.0);
+    }
+
+    const TimeControl &pick_time_control() {
+        double r = uniform();
+        for (const auto &tc : TIME_CONTROLS) {
+            if ((r -= tc.weight) <= 0) return tc;
+        }
+        return TIME_CONTROLS[N_TIME_CONTROLS - 1];
+    }
+
+    const TimeControl &pick_blitz() {
+        return TIME_CONTROLS[uniform_int(2, 5)];
+    }
+
+    std::string id(int length) {
+        static const char CHARS[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+        std::string text;
+        for (int i = 0; i < length; ++i) text += CHARS[uniform_int(0, 61)];
+        return text;
+    }
+
+    std::string player() {
+        std::string name = id(uniform_int(4, 14));
+        if (uniform() < 0.3) name += "_" + std::to_string(uniform_int(1, 2025));
+        return name;
+    }
+
+    static std::string two_digits(size_t value) {
+        char buf[8];
+        snprintf(buf, sizeof(buf), "%02zu", value);
+        return buf;
+    }
+
+    static void append_tag(std::string &out, const char *key, const std::string &value) {
+        out += '[';
+        out += key;
+        out += " \"";
+        out += value;
+        out += "\"]\n";
+    }
+
+    static std::string clock(int seconds) {
+        char buf[16];
+        snprintf(buf, sizeof(buf), "%d:%02d:%02d", seconds / 3600, seconds / 60 % 60, seconds % 60);
+        return buf;
+    }
+
+    std::string eval() {
+        if (uniform() < 0.03) {
+            std::string sign = uniform() < 0.5 ? "-" : "";  // urutan panggilan rng harus tetap
+            return "#" + sign + std::to_string(uniform_int(1, 9));
+        }
+        char buf[16];
+        snprintf(buf, sizeof(buf), "%.2f", normal(0.0, 2.0));
+        return buf;
+    }
+
+    // langkah pseudo-legal: tujuan dari tabel serangan chess_board.h,
+    // legalitas (pin, skak, rokade) dicek belakangan oleh to_san
+    static void candidate_moves(const chess::Board &board, std::vector<chess::Move> &moves) {
+        using namespace chess;
+        const detail::AttackTables &t = detail::tables();
+        Color us = board.side, them = Color(us ^ 1);
+        Bitboard own = board.colors[us], occupied = board.occupied();
+        moves.clear();
+
+        Bitboard pieces = own;
+        while (pieces) {
+            int from = pop_lsb(pieces);
+            int piece = board.squares[from];
+            Bitboard targets = 0;
+            switch (piece) {
+            case PAWN: {
+                int forward = us == WHITE ? 8 : -8;
+                targets = t.pawn[us][from] & (board.colors[them] | (board.ep >= 0 ? bit(board.ep) : 0));
+                if (!(occupied & bit(from + forward))) {
+                    targets |= bit(from + forward);
+                    bool start = from / 8 == (us == WHITE ? 1 : 6);
+                    if (start && !(occupied & bit(from + 2 * forward))) targets |= bit(from + 2 * forward);
+                }
+                break;
+            }
+            case KNIGHT: targets = t.knight[from]; break;
+            case BISHOP: targets = bishop_attacks(from, occupied); break;
+            case ROOK: targets = rook_attacks(from, occupied); break;
+            case QUEEN: targets = bishop_attacks(from, occupied) | rook_attacks(from, occupied); break;
+            default:
+                targets = t.king[from];
+                if (from == (us == WHITE ? 4 : 60) && board.castling) targets |= bit(from + 2) | bit(from - 2);
+                break;
+            }
+
+            targets &= ~own;
+            while (targets) {
+                int to = pop_lsb(targets);
+                if (piece == PAWN && (to / 8 == 7 || to / 8 == 0)) {
+                    for (int promotion : { QUEEN, ROOK, BISHOP, KNIGHT }) {
+                        moves.push_back(Move{ (uint8_t)from, (uint8_t)to, (uint8_t)promotion });
+                    }
+                } else {
+                    moves.push_back(Move{ (uint8_t)from, (uint8_t)to, NO_PIECE });
+                }
+            }
+        }
+    }
+
+    // SAN minimal ("Nf3", "Nbd2", "exd5", "e8=Q", "O-O") tanpa +/#,
+    // "" jika langkahnya ilegal: parse_san harus me-resolve SAN kembali
+    // ke langkah yang sama
+    static std::string to_san(const chess::Board &board, const chess::Move &move) {
+        using namespace chess;
+        int piece = board.squares[move.from];
+        std::string to{ char('a' + move.to % 8), char('1' + move.to / 8) };
+        std::vector<std::string> texts;
+        if (piece == KING && std::abs(move.to - move.from) == 2) {
+            texts = { move.to > move.from ? "O-O" : "O-O-O" };
+        } else if (piece == PAWN) {
+            std::string text = move.from % 8 != move.to % 8 ? std::string{ char('a' + move.from % 8), 'x' } + to : to;
+            if (move.promotion != NO_PIECE) text += std::string("=") + "PNBRQK"[move.promotion];
+            texts = { text };
+        } else {
+            std::string prefix(1, "PNBRQK"[piece]);
+            std::string capture = board.squares[move.to] != NO_PIECE ? "x" : "";
+            char file = char('a' + move.from % 8), rank = char('1' + move.from / 8);
+            texts = { prefix + capture + to, prefix + file + capture + to, prefix + rank + capture + to,
+                      prefix + file + rank + capture + to };
+        }
+
+        for (const std::string &text : texts) {
+            Move resolved;
+            if (board.parse_san(text, resolved) == SanError::NONE && resolved.from == move.from &&
+                resolved.to == move.to && resolved.promotion == move.promotion) {
+                return text;
+            }
+        }
+        return "";
+    }
+
+    // Line pembuka lalu langkah legal acak sampai plies. Langkah diambil acak
+    // dari kandidat pseudo-legal; yang ilegal dibuang dan diambil ulang, jadi
+    // tiap langkah legal sama peluangnya. Mat / stalemate mengakhiri game dan
+    // menentukan result.
+    void play(const Opening &opening, int plies, const char *&result) {
+        chess::Board board;
+        sans.clear();
+        for (int ply = 0; ply < plies; ++ply) {
+            chess::Move move;
+            std::string san;
+            if (ply < (int)opening.line.size()) {
+                san = opening.line[ply];
+                board.parse_san(san, move);
+            } else {
+                candidate_moves(board, candidates);
+                while (!candidates.empty()) {
+                    size_t pick = (size_t)(rng() % candidates.size());
+                    san = to_san(board, candidates[pick]);
+                    if (!san.empty()) {
+                        move = candidates[pick];
+                        break;
+                    }
+                    candidates[pick] = candidates.back();
+                    candidates.pop_back();
+                }
+                if (candidates.empty()) {  // tidak ada langkah legal
+                    if (board.in_check()) {
+                        sans.back().back() = '#';  // langkah terakhir sudah diberi '+'
+                        result = board.side == chess::WHITE ? "0-1" : "1-0";
+                    } else {
+                        result = "1/2-1/2";
+                    }
+                    break;
+                }
+            }
+
+            board.make(move);
+            if (board.in_check()) san += '+';
+            sans.push_back(san);
+        }
+    }
+
+    // movetext gaya Lichess: "1. e4 { [%clk 0:03:00] } 1... e5 { [%clk 0:03:00] } ..."
+    // Tanpa clock dan eval (sekitar 5% game) movetext tanpa komentar:
+    // "1. e4 e5 2. Nf3 Nc6", nomor langkah hitam tidak diulang.
+    void moves(std::string &out, const TimeControl &tc, const char *result) {
+        bool clocks = uniform() < 0.95;
+        bool evals = uniform() < 0.08;  // game yang sudah dianalisis
+        int clock_left[2] = { tc.base, tc.base };
+
+        for (int ply = 0; ply < (int)sans.size(); ++ply) {
+            int side = ply % 2;
+            bool comment = clocks || evals;
+            if (side == 0) {
+                out += std::to_string(ply / 2 + 1) + ". ";
+            } else if (comment) {
+                out += std::to_string(ply / 2 + 1) + "... ";  // Lichess mengulang nomor setelah komentar
+            }
+
+            out += sans[ply];
+            if (evals && uniform() < 0.04) out += uniform() < 0.5 ? "?!" : "?";
+
+            if (comment) {
+                out += " {";
+                if (evals) out += " [%eval " + eval() + "]";
+                if (clocks) {
+                    clock_left[side] = std::max(0, clock_left[side] - uniform_int(0, tc.base / 40 + 2) + tc.increment);
+                    out += " [%clk " + clock(clock_left[side]) + "]";
+                }
+                out += " }";
+            }
+            out += ' ';
+        }
+        out += result;
+    }
+};
+
+bool parse_options(int argc, char **argv, GeneratorOptions &options) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        std::string value = argv[i + 1];
+        if (arg == "--games") options.games = std::stoull(value);
+        else if (arg == "--keep-rate") options.keep_rate = std::stod(value);
+        else if (arg == "--seed") options.seed = std::stoul(value);
+        else if (arg == "--level") options.level = std::stoi(value);
+        else if (arg == "--frame-mb") options.frame_mb = std::stoull(value);
+        else if (arg == "--out") options.out = value;
+        else {
+            cerr << "[ERROR] Unknown option: " << arg << endl;
+            return false;
+        }
+    }
+    if (argc % 2 == 0) {
+        cerr << "Usage: bench_generate_pgn [--games N] [--keep-rate P] [--seed S] [--level L] [--frame-mb N] [--out FILE]" << endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    GeneratorOptions options;
+    if (!parse_options(argc, argv, options)) {
+        return 1;
+    }
+
+    std::ofstream fout(options.out, std::ios::binary);
+    if (!fout) {
+        cerr << "[ERROR] Cannot open output: " << options.out << endl;
+        return 1;
+    }
+
+    ZSTD_CCtx *cctx = ZSTD_createCCtx();
+    ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, options.level);
+
+    std::vector<char> out_buf(ZSTD_CStreamOutSize());
+    auto compress = [&](const std::string &text, ZSTD_EndDirective mode) {
+        ZSTD_inBuffer input{ text.data(), text.size(), 0 };
+        size_t remaining;
+        do {
+            ZSTD_outBuffer output{ out_buf.data(), out_buf.size(), 0 };
+            remaining = ZSTD_compressStream2(cctx, &output, &input, mode);
+            if (ZSTD_isError(remaining)) {
+                throw std::runtime_error(ZSTD_getErrorName(remaining));
+            }
+            fout.write(out_buf.data(), output.pos);
+        } while (mode == ZSTD_e_continue ? input.pos < input.size : remaining != 0);
+    };
+
+    Corpus corpus(options);
+    std::string text;
+    size_t frame_bytes = 0;
+    size_t total_bytes = 0;
+
+    for (size_t i = 0; i < options.games; ++i) {
+        corpus.game(text, i);
+        bool last = i + 1 == options.games;
+        if (text.size() < (1 << 20) && !last) continue;
+
+        frame_bytes += text.size();
+        total_bytes += text.size();
+        bool end_frame = last || (options.frame_mb > 0 && frame_bytes >= options.frame_mb << 20);
+        compress(text, end_frame ? ZSTD_e_end : ZSTD_e_continue);
+        if (end_frame) frame_bytes = 0;
+        text.clear();
+    }
+
+    ZSTD_freeCCtx(cctx);
+    fout.close();
+    if (!fout) {
+        cerr << "[ERROR] Cannot write output: " << options.out << endl;
+        return 1;
+    }
+
+    cout << "Games           : " << options.games << "\n"
+         << "PGN size        : " << total_bytes / 1048576.0 << " MB\n"
+         << "Output          : " << options.out << "\n";
+    return 0;
+}
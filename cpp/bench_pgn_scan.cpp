@@ -0,0 +1,164 @@
+// Micro-benchmark scanner struktural (pgn_scan.h) vs jalur lama find/memchr
+// per baris, di buffer hasil dekompresi yang sama. Kerja yang diukur sama
+// dengan tokenizer generate_data: batas baris, awal game "[Event", nilai tag
+// di antara quote dan komentar {...} di movetext. Hasil semua jalur harus sama.
+//
+// g++ -std=c++17 -O2 bench_pgn_scan.cpp -lzstd -lpthread -o bench_pgn_scan
+// ./bench_pgn_scan FILE.pgn.zst|FILE.pgn [--mb N] [--repeat N]
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "pgn_reader.h"
+#include "pgn_scan.h"
+
+using namespace std;
+
+struct ScanStats {
+    uint64_t lines = 0;
+    uint64_t games = 0;
+    uint64_t value_bytes = 0;    // panjang semua nilai tag
+    uint64_t comments = 0;
+    uint64_t comment_bytes = 0;
+
+    bool operator==(const ScanStats &o) const {
+        return lines == o.lines && games == o.games && value_bytes == o.value_bytes &&
+               comments == o.comments && comment_bytes == o.comment_bytes;
+    }
+};
+
+// jalur lama: find per baris dan per karakter yang dicari
+ScanStats tokenize_find(std::string_view text) {
+    ScanStats stats;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t line_end = std::min(text.find('\n', pos), text.size());
+        std::string_view line = text.substr(pos, line_end - pos);
+        pos = line_end + 1;
+        stats.lines++;
+
+        if (!line.empty() && line[0] == '[') {
+            if (line.rfind("[Event ", 0) == 0) stats.games++;
+            size_t start_val = line.find('"');
+            size_t end_val = line.rfind('"');
+            if (start_val != std::string_view::npos && end_val > start_val) stats.value_bytes += end_val - start_val - 1;
+            continue;
+        }
+
+        for (size_t open = line.find('{'); open != std::string_view::npos; open = line.find('{', open + 1)) {
+            size_t close = line.find('}', open + 1);
+            if (close == std::string_view::npos) break;
+            stats.comments++;
+            stats.comment_bytes += close - open - 1;
+            open = close;
+        }
+    }
+    return stats;
+}
+
+// jalur baru: satu pass pgn_scan::for_each, state machine per karakter struktural
+ScanStats tokenize_scanner(std::string_view text) {
+    static const size_t NONE = SIZE_MAX;
+    ScanStats stats;
+    size_t line_start = 0, first_quote = NONE, last_quote = NONE, open = NONE;
+    bool tag_line = !text.empty() && text[0] == '[';
+
+    auto finish_line = [&](size_t line_end) {
+        stats.lines++;
+        if (tag_line) {
+            if (text.substr(line_start, 7) == "[Event ") stats.games++;
+            if (first_quote != NONE && last_quote > first_quote) stats.value_bytes += last_quote - first_quote - 1;
+        }
+        line_start = line_end + 1;
+        first_quote = last_quote = open = NONE;
+        tag_line = line_start < text.size() && text[line_start] == '[';
+    };
+
+    static const pgn_scan::Class classes[] = { pgn_scan::NEWLINE, pgn_scan::QUOTE, pgn_scan::BRACE_OPEN, pgn_scan::BRACE_CLOSE };
+    pgn_scan::for_each(text, 0, text.size(), classes, [&](size_t pos, pgn_scan::Class c) {
+        if (c == pgn_scan::NEWLINE) {
+            finish_line(pos);
+        } else if (tag_line) {
+            if (c != pgn_scan::QUOTE) return true;
+            if (first_quote == NONE) first_quote = pos;
+            last_quote = pos;
+        } else if (c == pgn_scan::BRACE_OPEN) {
+            if (open == NONE) open = pos;
+        } else if (c == pgn_scan::BRACE_CLOSE && open != NONE) {
+            stats.comments++;
+            stats.comment_bytes += pos - open - 1;
+            open = NONE;
+        }
+        return true;
+    });
+    if (line_start < text.size()) finish_line(text.size());
+    return stats;
+}
+
+// game dari PgnStreamReader (zstd dikenali dari magic byte) sampai max_bytes
+bool read_input(const std::string &path, size_t max_bytes, std::string &text) {
+    PgnStreamReader reader(path);
+    GameView game;
+    while (text.size() < max_bytes && reader.next(game)) text.append(game.text);
+    if (!reader.ok()) {
+        cerr << "[ERROR] " << reader.error() << endl;
+        return false;
+    }
+    if (text.size() > max_bytes) text.resize(max_bytes);
+    return true;
+}
+
+// waktu terbaik dari beberapa ulangan, dalam detik
+template <typename F>
+double best_time(int repeat, F fn) {
+    double best = 1e30;
+    for (int r = 0; r < repeat; ++r) {
+        auto start = chrono::steady_clock::now();
+        fn();
+        best = std::min(best, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        cerr << "Usage: bench_pgn_scan FILE.pgn.zst|FILE.pgn [--mb N] [--repeat N]" << endl;
+        return 1;
+    }
+    std::string path = argv[1];
+    size_t max_mb = 256;
+    int repeat = 5;
+    for (int i = 2; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--mb") max_mb = std::stoul(argv[i + 1]);
+        else if (arg == "--repeat") repeat = std::max(1, std::stoi(argv[i + 1]));
+    }
+
+    std::string text;
+    if (!read_input(path, max_mb << 20, text)) return 1;
+    double mb = text.size() / 1048576.0;
+    cout << "Input   : " << fixed << setprecision(1) << mb << " MB decompressed" << endl;
+
+    ScanStats reference;
+    double base = best_time(repeat, [&] { reference = tokenize_find(text); });
+    cout << "Stats   : " << reference.lines << " lines, " << reference.games << " games, "
+         << reference.comments << " comments" << endl;
+    cout << left << setw(10) << "find" << right << fixed << setprecision(0) << setw(8) << mb / base << " MB/s" << endl;
+
+    bool ok = true;
+    for (const pgn_scan::Kernel &kernel : pgn_scan::available_kernels()) {
+        pgn_scan::set_kernel(kernel.name);
+        ScanStats stats;
+        double t = best_time(repeat, [&] { stats = tokenize_scanner(text); });
+        bool same = stats == reference;
+        ok = ok && same;
+        cout << left << setw(10) << kernel.name << right << fixed << setprecision(0) << setw(8) << mb / t << " MB/s"
+             << setprecision(2) << setw(8) << base / t << "x" << (same ? "" : "  MISMATCH") << endl;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,175 @@
+// Cek chess_board.h dengan perft di posisi uji standar (chessprogramming
+// wiki): start, Kiwipete, posisi 3-6. chess_board.h tidak punya move
+// generator, jadi langkah legal dicari lewat parse_san: untuk tiap from / to
+// dicoba SAN yang sepenuhnya didisambiguasi (plus promosi dan rokade). Yang
+// diuji sama dengan jalur replay: resolusi SAN, legalitas (pin, skak, en
+// passant, rokade), make() dan set_fen / fen. Selain itu movetext utuh
+// (dengan dan tanpa komentar) dibersihkan clean_moves dan di-replay dari
+// MoveText::san sampai FEN akhir.
+//
+// g++ -std=c++17 -O2 check_chess_board.cpp -o check_chess_board            (magic bitboard)
+// g++ -std=c++17 -O2 -mbmi2 check_chess_board.cpp -o check_chess_board     (PEXT)
+// ./check_chess_board [--quick]
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "chess_board.h"
+#include "movetext.h"
+
+using namespace std;
+using namespace chess;
+
+struct PerftCase {
+    const char *name;
+    const char *fen;
+    int depth;
+    uint64_t nodes;
+    int quick_depth;  // --quick: kedalaman lebih kecil
+    uint64_t quick_nodes;
+};
+
+static const PerftCase CASES[] = {
+    { "start", START_FEN, 4, 197281, 3, 8902 },
+    { "kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 3, 97862, 2, 2039 },
+    { "position3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 5, 674624, 4, 43238 },
+    { "position4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 4, 422333, 3, 9467 },
+    { "position5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 3, 62379, 2, 1486 },
+    { "position6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 3, 89890, 2, 2079 },
+};
+
+struct ReplayCase {
+    const char *name;
+    const char *movetext;
+    const char *fen;  // posisi setelah langkah terakhir
+};
+
+static const char *const OPERA_FEN = "1n1Rkb1r/p4ppp/4q3/4p1B1/4P3/8/PPP2PPP/2K5 b k - 1 17";
+
+static const ReplayCase REPLAYS[] = {
+    // tanpa komentar (correspondence, game lama): kolom moves jadi "e4e5 Nf3d6 ..."
+    { "opera", "1. e4 e5 2. Nf3 d6 3. d4 Bg4 4. dxe5 Bxf3 5. Qxf3 dxe5 6. Bc4 Nf6 7. Qb3 Qe7\n"
+               "8. Nc3 c6 9. Bg5 b5 10. Nxb5 cxb5 11. Bxb5+ Nbd7 12. O-O-O Rd8 13. Rxd7 Rxd7\n"
+               "14. Rd1 Qe6 15. Bxd7+ Nxd7 16. Qb8+! Nxb8 17. Rd8# 1-0\n", OPERA_FEN },
+    { "opera_clk", "1. e4 { [%clk 0:10:00] } 1... e5 { [%clk 0:10:00] } 2. Nf3 2... d6 3. d4 3... Bg4 4. dxe5 "
+                   "4... Bxf3 5. Qxf3 5... dxe5 6. Bc4 6... Nf6 7. Qb3 7... Qe7 8. Nc3 8... c6 9. Bg5 9... b5 "
+                   "10. Nxb5 10... cxb5 11. Bxb5+ 11... Nbd7 12. O-O-O 12... Rd8 13. Rxd7 13... Rxd7 14. Rd1 "
+                   "14... Qe6 15. Bxd7+ 15... Nxd7 16. Qb8+ 16... Nxb8 17. Rd8# 1-0", OPERA_FEN },
+};
+
+// replay seperti replay_game_moves, "" jika ada SAN yang gagal
+std::string replay_fen(const char *movetext) {
+    MoveText move_text;
+    clean_moves(movetext, move_text);
+    Board board;
+    std::string_view moves = move_text.san;
+    size_t pos = 0;
+    while (pos < moves.size()) {
+        size_t end = std::min(moves.find(' ', pos), moves.size());
+        std::string_view san = moves.substr(pos, end - pos);
+        pos = end + 1;
+        Move move;
+        if (board.parse_san(san, move) != SanError::NONE) return "";
+        board.make(move);
+    }
+    return board.fen();
+}
+
+// semua langkah legal: SAN "Ng1f3" / "exd5" / "e8=Q" untuk tiap pasangan from / to
+std::vector<Move> legal_moves(const Board &board) {
+    std::vector<Move> moves;
+    std::string san;
+    for (int from = 0; from < 64; ++from) {
+        if (!(board.colors[board.side] & bit(from))) continue;
+        int piece = board.squares[from];
+        for (int to = 0; to < 64; ++to) {
+            if (piece == KING && std::abs(to - from) == 2 && from / 8 == to / 8) continue;  // rokade di bawah
+
+            san.clear();
+            if (piece == PAWN) {
+                if (from % 8 != to % 8) {
+                    san += char('a' + from % 8);
+                    san += 'x';
+                }
+            } else {
+                san += "PNBRQK"[piece];
+                san += char('a' + from % 8);
+                san += char('1' + from / 8);
+            }
+            san += char('a' + to % 8);
+            san += char('1' + to / 8);
+
+            bool promotion = piece == PAWN && (to / 8 == 7 || to / 8 == 0);
+            for (const char *suffix : { "=Q", "=R", "=B", "=N" }) {
+                Move move;
+                std::string text = promotion ? san + suffix : san;
+                if (board.parse_san(text, move) == SanError::NONE && move.from == from && move.to == to) {
+                    moves.push_back(move);
+                }
+                if (!promotion) break;
+            }
+        }
+    }
+    for (const char *castle : { "O-O", "O-O-O" }) {
+        Move move;
+        if (board.parse_san(castle, move) == SanError::NONE) moves.push_back(move);
+    }
+    return moves;
+}
+
+uint64_t perft(const Board &board, int depth) {
+    if (depth == 0) return 1;
+    std::vector<Move> moves = legal_moves(board);
+    if (depth == 1) return moves.size();
+    uint64_t nodes = 0;
+    for (const Move &move : moves) {
+        Board next = board;
+        next.make(move);
+        nodes += perft(next, depth - 1);
+    }
+    return nodes;
+}
+
+int main(int argc, char **argv) {
+    bool quick = argc > 1 && std::string(argv[1]) == "--quick";
+#if defined(__BMI2__)
+    cout << "Slider  : PEXT" << endl;
+#else
+    cout << "Slider  : magic" << endl;
+#endif
+
+    bool ok = true;
+    for (const PerftCase &test : CASES) {
+        Board board;
+        if (!board.set_fen(test.fen)) {
+            cout << left << setw(10) << test.name << "  FEN REJECTED" << endl;
+            ok = false;
+            continue;
+        }
+        bool round_trip = board.fen() == test.fen;
+
+        int depth = quick ? test.quick_depth : test.depth;
+        uint64_t expected = quick ? test.quick_nodes : test.nodes;
+        auto start = std::chrono::steady_clock::now();
+        uint64_t nodes = perft(board, depth);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        bool same = nodes == expected && round_trip;
+        ok = ok && same;
+        cout << left << setw(10) << test.name << right << " depth " << depth << setw(10) << nodes << " nodes"
+             << fixed << setprecision(2) << setw(8) << seconds << " s"
+             << (nodes == expected ? "" : "  MISMATCH (expected " + std::to_string(expected) + ")")
+             << (round_trip ? "" : "  FEN ROUND TRIP") << endl;
+    }
+
+    for (const ReplayCase &test : REPLAYS) {
+        std::string fen = replay_fen(test.movetext);
+        bool same = fen == test.fen;
+        ok = ok && same;
+        cout << left << setw(10) << test.name << " replay " << (same ? "ok" : "MISMATCH \"" + fen + "\"") << endl;
+    }
+    return ok ? 0 : 1;
+}
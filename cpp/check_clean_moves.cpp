@@ -0,0 +1,139 @@
+// Cek clean_moves (movetext.h) terhadap rantai std::regex_replace lama dari
+// parse_game_moves: moves, jumlah langkah putih dan hitam harus identik,
+// dengan dan tanpa anotasi. san dicek terhadap rantai yang sama tapi
+// whitespace jadi pemisah token (tanpa komentar "1. e4 e5" -> "e4 e5"). Input = kasus tetap + string acak yang disusun
+// dari potongan movetext (nomor langkah, komentar, result, "!?", header,
+// "\r", dst.), seed tetap jadi hasilnya bisa diulang.
+//
+// g++ -std=c++17 -O2 check_clean_moves.cpp -o check_clean_moves
+// ./check_clean_moves [jumlah string acak, default 100000]
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <regex>
+#include <sstream>
+#include <string>
+
+#include "movetext.h"
+
+using namespace std;
+
+// versi lama, disalin apa adanya (termasuk kebiasaannya: "*" dan $n tetap ada)
+void regex_clean_moves(const string &raw_game, string &moves_str, int &w_count, int &b_count) {
+    std::string line;
+    std::stringstream ss(raw_game);
+    moves_str.clear();
+
+    while (std::getline(ss, line)) {
+        if (!line.empty() && line[0] == '[') continue;
+        moves_str += line + " ";
+    }
+
+    moves_str = std::regex_replace(moves_str, std::regex(R"(\{.*?\})"), "");
+    moves_str = std::regex_replace(moves_str, std::regex(R"(\d+\.\.\.)"), ",");
+    moves_str = std::regex_replace(moves_str, std::regex(R"(\d+\.)"), ".");
+    moves_str = std::regex_replace(moves_str, std::regex(R"(\s*(1-0|0-1|1/2-1/2)\s*$)"), "");
+    moves_str = std::regex_replace(moves_str, std::regex(R"([!?])"), "");
+    moves_str = std::regex_replace(moves_str, std::regex(R"(\s+)"), "");
+
+    w_count = moves_str.empty() ? 0 : std::count(moves_str.begin(), moves_str.end(), '.');
+    b_count = moves_str.empty() ? 0 : std::count(moves_str.begin(), moves_str.end(), ',');
+
+    moves_str = std::regex_replace(moves_str, std::regex(R"(\,)"), " ");
+    moves_str = std::regex_replace(moves_str, std::regex(R"(\.)"), " ");
+    moves_str = std::regex_replace(moves_str, std::regex(R"(^\s+)"), "");
+}
+
+// token SAN untuk replay: urutan regex sama, tapi whitespace dan penanda
+// langkah memisah token, bukan dibuang
+void regex_san(const string &raw_game, string &san) {
+    std::string line, text;
+    std::stringstream ss(raw_game);
+    while (std::getline(ss, line)) {
+        if (!line.empty() && line[0] == '[') continue;
+        text += line + " ";
+    }
+
+    text = std::regex_replace(text, std::regex(R"(\{.*?\})"), "");
+    text = std::regex_replace(text, std::regex(R"(\d+\.\.\.)"), ",");
+    text = std::regex_replace(text, std::regex(R"(\d+\.)"), ".");
+    text = std::regex_replace(text, std::regex(R"(\s*(1-0|0-1|1/2-1/2)\s*$)"), "");
+    text = std::regex_replace(text, std::regex(R"([!?])"), "");
+    text = std::regex_replace(text, std::regex(R"([.,])"), " ");
+
+    std::stringstream tokens(text);
+    std::string token;
+    san.clear();
+    while (tokens >> token) {
+        if (!san.empty()) san += ' ';
+        san += token;
+    }
+}
+
+static const char *const CASES[] = {
+    "",
+    "1. e4 e5 2. Nf3 Nc6 3. Bb5 a6 1-0",  // tanpa komentar: moves "e4e5 Nf3Nc6 Bb5a6", san terpisah
+    "1. e4 e5 2. Nf3",
+    "[Event \"Casual Correspondence game\"]\n\n1. d4 Nf6 2. c4 e6\n3. Nc3 Bb4 4. Qc2 O-O 0-1\n",
+    "1. e4 { [%eval 0.17] [%clk 0:03:00] } 1... c5 { [%eval 0.19] [%clk 0:03:00] } 2. Nf3 0-1",
+    "[Event \"Rated Blitz game\"]\n[Site \"x\"]\n\n1. d4 d5 2. c4?! dxc4!! 1/2-1/2\n",
+    "1. e4 e5 2. Qh5?? Nc6 3. Bc4 Nf6 4. Qxf7# 1-0",
+    "1. e4 {unclosed comment\n2. d4 1-0",
+    "1. e4 e5 *",
+    "1. e4 $1 e5 $2 1-0",
+    "12... Kxe1 13. O-O-O 0-1\r\n",
+    "1.e4 e5 2.Nf3 1/2-1/21-0",
+    "1-0",
+};
+
+static const char *const ATOMS[] = {
+    "1", ".", "...", "2", "12", " ", "e4", "Nf3", "{", "}", "{ [%clk 0:01:00] }", "{ [%eval #-3] }",
+    "!", "?", "1-0", "0-1", "1/2-1/2", "\n", "\n[Foo \"x\"]\n", "-", "/", "\t", "*", ",", "Qxf7+",
+    "O-O", "\r",
+};
+
+int main(int argc, char **argv) {
+    long iterations = argc > 1 ? std::stol(argv[1]) : 100000;
+
+    MoveText plain, annotated;
+    string expected, expected_san;
+    long checked = 0, mismatches = 0;
+
+    auto check = [&](const string &movetext) {
+        int white, black;
+        regex_clean_moves(movetext, expected, white, black);
+        regex_san(movetext, expected_san);
+        clean_moves(movetext, plain);
+        clean_moves(movetext, annotated, true);
+        checked++;
+
+        bool same = plain.moves == expected && plain.white_moves == white && plain.black_moves == black &&
+                    annotated.moves == expected && annotated.white_moves == white && annotated.black_moves == black &&
+                    plain.san == expected_san && annotated.san == expected_san;
+        if (same) return;
+        if (mismatches++ < 10) {
+            cout << "MISMATCH \"" << movetext << "\"\n"
+                 << "  regex         : \"" << expected << "\" " << white << " " << black << " san \"" << expected_san
+                 << "\"\n"
+                 << "  clean_moves   : \"" << plain.moves << "\" " << plain.white_moves << " " << plain.black_moves
+                 << " san \"" << plain.san << "\"\n";
+        }
+    };
+
+    for (const char *movetext : CASES) check(movetext);
+
+    std::mt19937 rng(42);
+    const size_t atom_count = sizeof(ATOMS) / sizeof(*ATOMS);
+    string movetext;
+    for (long i = 0; i < iterations; ++i) {
+        movetext.clear();
+        int length = rng() % 14;
+        for (int k = 0; k < length; ++k) movetext += ATOMS[rng() % atom_count];
+        check(movetext);
+    }
+
+    cout << "Checked     : " << checked << " movetext" << endl;
+    cout << "Mismatches  : " << mismatches << endl;
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,697 @@
+#pragma once
+
+// Papan bitboard untuk replay movetext SAN tanpa python-chess:
+//
+//   chess::Board board;               // posisi awal, atau board.set_fen(...)
+//   chess::Move move;
+//   if (board.parse_san("Nbd2", move) == chess::SanError::NONE) board.make(move);
+//
+// Square a1 = 0 ... h8 = 63. Serangan bidak luncur (bishop / rook / queen)
+// dari tabel magic bitboard yang dicari sekali saat tabel pertama dipakai,
+// atau PEXT kalau dikompilasi dengan BMI2 (-mbmi2 / -march=native).
+// SAN yang ilegal atau ambigu menghasilkan SanError, tidak pernah exception.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace chess {
+
+using Bitboard = uint64_t;
+
+enum Color { WHITE, BLACK };
+enum Piece { PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING, NO_PIECE };
+
+enum class SanError { NONE, SYNTAX, ILLEGAL, AMBIGUOUS };
+
+// hak rokade
+enum Castling { WHITE_OO = 1, WHITE_OOO = 2, BLACK_OO = 4, BLACK_OOO = 8 };
+
+constexpr const char *START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+constexpr Bitboard FILE_A = 0x0101010101010101ull;
+constexpr Bitboard RANK_1 = 0xFFull;
+
+constexpr Bitboard bit(int square) {
+    return Bitboard(1) << square;
+}
+
+inline int lsb(Bitboard b) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, b);
+    return (int)index;
+#else
+    return __builtin_ctzll(b);
+#endif
+}
+
+inline int popcount(Bitboard b) {
+#if defined(_MSC_VER)
+    return (int)__popcnt64(b);
+#else
+    return __builtin_popcountll(b);
+#endif
+}
+
+inline int pop_lsb(Bitboard &b) {
+    int square = lsb(b);
+    b &= b - 1;
+    return square;
+}
+
+struct Move {
+    uint8_t from = 0;
+    uint8_t to = 0;
+    uint8_t promotion = NO_PIECE;  // bidak hasil promosi
+
+    // 16 bit: from | to << 6 | promosi << 12 (0 = tanpa promosi)
+    uint16_t pack() const {
+        return (uint16_t)(from | to << 6 | (promotion == NO_PIECE ? 0 : promotion) << 12);
+    }
+
+    static Move unpack(uint16_t code) {
+        int promotion = code >> 12;
+        return Move{ (uint8_t)(code & 63), (uint8_t)(code >> 6 & 63), (uint8_t)(promotion ? promotion : NO_PIECE) };
+    }
+};
+
+// Tabel serangan satu bidak luncur di satu square: index = occupancy
+// relevan (mask) di-hash dengan magic, atau di-PEXT
+struct Magic {
+    Bitboard mask = 0;
+    Bitboard magic = 0;
+    unsigned shift = 0;
+    Bitboard *attacks = nullptr;
+
+    size_t index(Bitboard occupied) const {
+#if defined(__BMI2__)
+        return (size_t)_pext_u64(occupied, mask);
+#else
+        return (size_t)(((occupied & mask) * magic) >> shift);
+#endif
+    }
+};
+
+namespace detail {
+
+constexpr int BISHOP_DIRS[4][2] = { { 1, 1 }, { 1, -1 }, { -1, 1 }, { -1, -1 } };
+constexpr int ROOK_DIRS[4][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+
+// serangan lambat dengan menelusuri ray, hanya untuk membangun tabel
+inline Bitboard ray_attacks(int square, Bitboard occupied, const int (*dirs)[2]) {
+    Bitboard attacks = 0;
+    for (int d = 0; d < 4; ++d) {
+        int rank = square / 8 + dirs[d][0], file = square % 8 + dirs[d][1];
+        while (rank >= 0 && rank < 8 && file >= 0 && file < 8) {
+            attacks |= bit(rank * 8 + file);
+            if (occupied & bit(rank * 8 + file)) break;
+            rank += dirs[d][0];
+            file += dirs[d][1];
+        }
+    }
+    return attacks;
+}
+
+// square yang occupancy-nya menentukan serangan: ray tanpa square di tepi
+inline Bitboard ray_mask(int square, const int (*dirs)[2]) {
+    Bitboard mask = 0;
+    for (int d = 0; d < 4; ++d) {
+        int rank = square / 8 + dirs[d][0], file = square % 8 + dirs[d][1];
+        while (rank + dirs[d][0] >= 0 && rank + dirs[d][0] < 8 && file + dirs[d][1] >= 0 && file + dirs[d][1] < 8) {
+            mask |= bit(rank * 8 + file);
+            rank += dirs[d][0];
+            file += dirs[d][1];
+        }
+    }
+    return mask;
+}
+
+inline Bitboard step_attacks(int square, const int (*steps)[2], int count) {
+    Bitboard attacks = 0;
+    for (int i = 0; i < count; ++i) {
+        int rank = square / 8 + steps[i][0], file = square % 8 + steps[i][1];
+        if (rank >= 0 && rank < 8 && file >= 0 && file < 8) attacks |= bit(rank * 8 + file);
+    }
+    return attacks;
+}
+
+struct AttackTables {
+    Bitboard knight[64];
+    Bitboard king[64];
+    Bitboard pawn[2][64];  // square yang diserang pion warna c dari square
+    Magic bishop[64];
+    Magic rook[64];
+    std::vector<Bitboard> slider;  // storage serangan semua entry Magic
+
+    AttackTables() {
+        static const int KNIGHT_STEPS[8][2] = { { 1, 2 }, { 2, 1 }, { 2, -1 }, { 1, -2 },
+                                                { -1, -2 }, { -2, -1 }, { -2, 1 }, { -1, 2 } };
+        static const int KING_STEPS[8][2] = { { 1, 0 }, { 1, 1 }, { 0, 1 }, { -1, 1 },
+                                              { -1, 0 }, { -1, -1 }, { 0, -1 }, { 1, -1 } };
+        static const int PAWN_STEPS[2][2][2] = { { { 1, -1 }, { 1, 1 } }, { { -1, -1 }, { -1, 1 } } };
+
+        size_t total = 0;
+        for (int square = 0; square < 64; ++square) {
+            knight[square] = step_attacks(square, KNIGHT_STEPS, 8);
+            king[square] = step_attacks(square, KING_STEPS, 8);
+            pawn[WHITE][square] = step_attacks(square, PAWN_STEPS[WHITE], 2);
+            pawn[BLACK][square] = step_attacks(square, PAWN_STEPS[BLACK], 2);
+            bishop[square].mask = ray_mask(square, BISHOP_DIRS);
+            rook[square].mask = ray_mask(square, ROOK_DIRS);
+            total += (size_t(1) << popcount(bishop[square].mask)) + (size_t(1) << popcount(rook[square].mask));
+        }
+
+        // pointer ke slider baru diambil setelah ukurannya tetap
+        slider.resize(total);
+        Bitboard *next = slider.data();
+        for (int square = 0; square < 64; ++square) {
+            next = init_magic(bishop[square], square, BISHOP_DIRS, next);
+            next = init_magic(rook[square], square, ROOK_DIRS, next);
+        }
+    }
+
+    // isi tabel satu square; tanpa BMI2 cari magic yang tidak bertabrakan
+    static Bitboard *init_magic(Magic &m, int square, const int (*dirs)[2], Bitboard *table) {
+        int bits = popcount(m.mask);
+        size_t size = size_t(1) << bits;
+        m.shift = 64 - bits;
+        m.attacks = table;
+
+        std::vector<Bitboard> occupancy(size), attacks(size);
+        Bitboard subset = 0;
+        for (size_t i = 0; i < size; ++i) {  // semua subset mask (Carry-Rippler)
+            occupancy[i] = subset;
+            attacks[i] = ray_attacks(square, subset, dirs);
+            subset = (subset - m.mask) & m.mask;
+        }
+
+#if defined(__BMI2__)
+        for (size_t i = 0; i < size; ++i) table[m.index(occupancy[i])] = attacks[i];
+#else
+        // xorshift64* dengan seed per rank (seed Stockfish yang cepat menemukan
+        // magic), jadi pencarian selesai dalam hitungan milidetik
+        static const uint64_t RANK_SEEDS[8] = { 728, 10316, 55013, 32803, 12281, 15100, 16645, 255 };
+        uint64_t seed = RANK_SEEDS[square / 8];
+        auto random = [&seed]() {
+            seed ^= seed >> 12;
+            seed ^= seed << 25;
+            seed ^= seed >> 27;
+            return seed * 0x2545F4914F6CDD1Dull;
+        };
+
+        std::vector<unsigned> epoch(size, 0);
+        for (unsigned attempt = 1;; ++attempt) {
+            m.magic = random() & random() & random();  // magic yang baik punya sedikit bit
+            if (popcount((m.mask * m.magic) >> 56) < 6) continue;
+
+            bool ok = true;
+            for (size_t i = 0; i < size && ok; ++i) {
+                size_t index = m.index(occupancy[i]);
+                if (epoch[index] != attempt) {
+                    epoch[index] = attempt;
+                    table[index] = attacks[i];
+                } else if (table[index] != attacks[i]) {
+                    ok = false;
+                }
+            }
+            if (ok) break;
+        }
+#endif
+        return table + size;
+    }
+};
+
+inline const AttackTables &tables() {
+    static const AttackTables instance;
+    return instance;
+}
+
+// Key Zobrist acak dengan seed tetap (splitmix64), jadi hash sama antar run
+struct ZobristKeys {
+    uint64_t piece[2][6][64];
+    uint64_t side;
+    uint64_t castling[16];
+    uint64_t ep_file[8];
+
+    ZobristKeys() {
+        uint64_t state = 0x5A0B1C2D3E4F6071ull;
+        auto next = [&state]() {
+            uint64_t z = state += 0x9E3779B97F4A7C15ull;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        };
+        for (auto &color : piece) {
+            for (auto &squares : color) {
+                for (uint64_t &key : squares) key = next();
+            }
+        }
+        side = next();
+        castling[0] = 0;
+        for (int i = 1; i < 16; ++i) castling[i] = next();
+        for (uint64_t &key : ep_file) key = next();
+    }
+};
+
+inline const ZobristKeys &zobrist() {
+    static const ZobristKeys instance;
+    return instance;
+}
+
+} // namespace detail
+
+inline Bitboard bishop_attacks(int square, Bitboard occupied) {
+    const Magic &m = detail::tables().bishop[square];
+    return m.attacks[m.index(occupied)];
+}
+
+inline Bitboard rook_attacks(int square, Bitboard occupied) {
+    const Magic &m = detail::tables().rook[square];
+    return m.attacks[m.index(occupied)];
+}
+
+class Board {
+public:
+    Bitboard pieces[2][6]{};
+    Bitboard colors[2]{};
+    uint8_t squares[64]{};  // Piece per square, NO_PIECE jika kosong
+    Color side = WHITE;
+    unsigned castling = 0;
+    int ep = -1;  // square en passant setelah pion maju dua, -1 jika tidak ada
+    int halfmove = 0;
+    int fullmove = 1;
+
+    Board() {
+        set_fen(START_FEN);
+    }
+
+    Bitboard occupied() const {
+        return colors[WHITE] | colors[BLACK];
+    }
+
+    int king_square(Color color) const {
+        return lsb(pieces[color][KING]);
+    }
+
+    // bidak warna by yang menyerang square dengan occupancy tertentu
+    Bitboard attackers(int square, Color by, Bitboard occupied) const {
+        const detail::AttackTables &t = detail::tables();
+        return (t.knight[square] & pieces[by][KNIGHT]) | (t.king[square] & pieces[by][KING]) |
+               (t.pawn[by ^ 1][square] & pieces[by][PAWN]) |
+               (bishop_attacks(square, occupied) & (pieces[by][BISHOP] | pieces[by][QUEEN])) |
+               (rook_attacks(square, occupied) & (pieces[by][ROOK] | pieces[by][QUEEN]));
+    }
+
+    bool in_check() const {
+        return attackers(king_square(side), Color(side ^ 1), occupied()) != 0;
+    }
+
+    // Hash Zobrist posisi (bidak, giliran, hak rokade, file en passant).
+    // Seperti Polyglot, en passant hanya dihitung jika ada pion yang bisa
+    // mengambilnya, jadi transposisi lewat langkah pion dua square tetap sama.
+    uint64_t hash() const {
+        const detail::ZobristKeys &keys = detail::zobrist();
+        uint64_t key = keys.castling[castling];
+        for (int color = WHITE; color <= BLACK; ++color) {
+            for (int piece = PAWN; piece <= KING; ++piece) {
+                Bitboard b = pieces[color][piece];
+                while (b) key ^= keys.piece[color][piece][pop_lsb(b)];
+            }
+        }
+        if (side == BLACK) key ^= keys.side;
+        if (ep >= 0 && (detail::tables().pawn[side ^ 1][ep] & pieces[side][PAWN])) key ^= keys.ep_file[ep % 8];
+        return key;
+    }
+
+    // material putih - hitam (P=1, N=B=3, R=5, Q=9)
+    int material() const {
+        static const int VALUE[5] = { 1, 3, 3, 5, 9 };
+        int balance = 0;
+        for (int piece = PAWN; piece < KING; ++piece) {
+            balance += VALUE[piece] * (popcount(pieces[WHITE][piece]) - popcount(pieces[BLACK][piece]));
+        }
+        return balance;
+    }
+
+    // FEN 6 field, false jika tidak valid (posisi tidak diubah)
+    bool set_fen(std::string_view fen) {
+        Board board = *this;
+        board.clear();
+
+        size_t pos = 0;
+        auto next_field = [&]() {
+            while (pos < fen.size() && fen[pos] == ' ') pos++;
+            size_t end = std::min(fen.find(' ', pos), fen.size());
+            std::string_view field = fen.substr(pos, end - pos);
+            pos = end;
+            return field;
+        };
+
+        int rank = 7, file = 0;
+        for (char c : next_field()) {
+            if (c == '/') {
+                if (file != 8 || rank == 0) return false;
+                rank--;
+                file = 0;
+            } else if (c >= '1' && c <= '8') {
+                file += c - '0';
+                if (file > 8) return false;
+            } else {
+                int piece = piece_from_char(c);
+                if (piece == NO_PIECE || file > 7) return false;
+                board.put(c >= 'a' ? BLACK : WHITE, piece, rank * 8 + file);
+                file++;
+            }
+        }
+        if (rank != 0 || file != 8) return false;
+        if (popcount(board.pieces[WHITE][KING]) != 1 || popcount(board.pieces[BLACK][KING]) != 1) return false;
+
+        std::string_view side_field = next_field();
+        if (side_field != "w" && side_field != "b") return false;
+        board.side = side_field == "w" ? WHITE : BLACK;
+
+        std::string_view castling_field = next_field();
+        if (castling_field != "-") {
+            for (char c : castling_field) {
+                if (c == 'K') board.castling |= WHITE_OO;
+                else if (c == 'Q') board.castling |= WHITE_OOO;
+                else if (c == 'k') board.castling |= BLACK_OO;
+                else if (c == 'q') board.castling |= BLACK_OOO;
+                else return false;  // Chess960 (Shredder / X-FEN) tidak didukung
+            }
+        }
+
+        std::string_view ep_field = next_field();
+        if (ep_field.size() == 2 && ep_field[0] >= 'a' && ep_field[0] <= 'h' && (ep_field[1] == '3' || ep_field[1] == '6')) {
+            board.ep = (ep_field[1] - '1') * 8 + (ep_field[0] - 'a');
+        } else if (ep_field != "-") {
+            return false;
+        }
+
+        // jam langkah opsional
+        std::string_view halfmove_field = next_field(), fullmove_field = next_field();
+        if (!halfmove_field.empty() && !parse_number(halfmove_field, board.halfmove)) return false;
+        if (!fullmove_field.empty() && !parse_number(fullmove_field, board.fullmove)) return false;
+
+        *this = board;
+        return true;
+    }
+
+    void append_fen(std::string &out) const {
+        for (int rank = 7; rank >= 0; --rank) {
+            int empty = 0;
+            for (int file = 0; file < 8; ++file) {
+                int square = rank * 8 + file;
+                if (squares[square] == NO_PIECE) {
+                    empty++;
+                    continue;
+                }
+                if (empty) out += char('0' + empty);
+                empty = 0;
+                char c = "PNBRQK"[squares[square]];
+                out += colors[BLACK] & bit(square) ? char(c - 'A' + 'a') : c;
+            }
+            if (empty) out += char('0' + empty);
+            if (rank) out += '/';
+        }
+
+        out += side == WHITE ? " w " : " b ";
+        if (!castling) out += '-';
+        if (castling & WHITE_OO) out += 'K';
+        if (castling & WHITE_OOO) out += 'Q';
+        if (castling & BLACK_OO) out += 'k';
+        if (castling & BLACK_OOO) out += 'q';
+
+        // seperti python-chess: square en passant hanya ditulis jika bisa diambil secara legal
+        out += ' ';
+        if (ep >= 0 && ep_capturable()) {
+            out += char('a' + ep % 8);
+            out += char('1' + ep / 8);
+        } else {
+            out += '-';
+        }
+        out += ' ';
+        out += std::to_string(halfmove);
+        out += ' ';
+        out += std::to_string(fullmove);
+    }
+
+    std::string fen() const {
+        std::string out;
+        append_fen(out);
+        return out;
+    }
+
+    // Resolve SAN ke langkah legal. Suffix +/# diabaikan; tanda "x" pada
+    // bidak selain pion tidak dicek terhadap isi square tujuan.
+    SanError parse_san(std::string_view san, Move &move) const {
+        while (!san.empty() && (san.back() == '+' || san.back() == '#')) san.remove_suffix(1);
+        if (san == "O-O" || san == "0-0") return parse_castle(false, move);
+        if (san == "O-O-O" || san == "0-0-0") return parse_castle(true, move);
+
+        int piece = PAWN;
+        if (!san.empty() && san[0] >= 'B' && san[0] <= 'R') {
+            piece = piece_from_char(san[0]);
+            if (piece == NO_PIECE || piece == PAWN) return SanError::SYNTAX;
+            san.remove_prefix(1);
+        }
+
+        int promotion = NO_PIECE;
+        if (san.size() >= 2 && san[san.size() - 2] == '=') {
+            promotion = piece_from_char(san.back());
+            san.remove_suffix(2);
+            if (promotion == NO_PIECE || promotion == PAWN || promotion == KING) return SanError::SYNTAX;
+        } else if (piece == PAWN && !san.empty() && (san.back() == 'N' || san.back() == 'B' || san.back() == 'R' || san.back() == 'Q')) {
+            promotion = piece_from_char(san.back());  // "e8Q" tanpa "="
+            san.remove_suffix(1);
+        }
+
+        if (san.size() < 2) return SanError::SYNTAX;
+        char to_file = san[san.size() - 2], to_rank = san[san.size() - 1];
+        if (to_file < 'a' || to_file > 'h' || to_rank < '1' || to_rank > '8') return SanError::SYNTAX;
+        int to = (to_rank - '1') * 8 + (to_file - 'a');
+        san.remove_suffix(2);
+
+        bool capture = !san.empty() && san.back() == 'x';
+        if (capture) san.remove_suffix(1);
+
+        int from_file = -1, from_rank = -1;
+        for (char c : san) {
+            if (c >= 'a' && c <= 'h' && from_file < 0) from_file = c - 'a';
+            else if (c >= '1' && c <= '8' && from_rank < 0) from_rank = c - '1';
+            else return SanError::SYNTAX;
+        }
+
+        Color them = Color(side ^ 1);
+        if (colors[side] & bit(to)) return SanError::ILLEGAL;
+
+        Bitboard candidates = 0;
+        if (piece == PAWN) {
+            bool last_rank = to / 8 == (side == WHITE ? 7 : 0);
+            if (last_rank != (promotion != NO_PIECE)) return SanError::ILLEGAL;
+
+            int forward = side == WHITE ? 8 : -8;
+            if (capture || from_file >= 0) {
+                if ((colors[them] & bit(to)) || to == ep) {
+                    candidates = detail::tables().pawn[them][to] & pieces[side][PAWN];
+                }
+            } else if (!(occupied() & bit(to))) {
+                int one = to - forward;
+                if (pieces[side][PAWN] & bit(one)) {
+                    candidates = bit(one);
+                } else if (squares[one] == NO_PIECE && to / 8 == (side == WHITE ? 3 : 4) &&
+                           (pieces[side][PAWN] & bit(one - forward))) {
+                    candidates = bit(one - forward);
+                }
+            }
+        } else {
+            if (promotion != NO_PIECE) return SanError::SYNTAX;
+            candidates = attacks_to(piece, to) & pieces[side][piece];
+        }
+
+        if (from_file >= 0) candidates &= FILE_A << from_file;
+        if (from_rank >= 0) candidates &= RANK_1 << (8 * from_rank);
+
+        bool found = false;
+        while (candidates) {
+            Move candidate{ (uint8_t)pop_lsb(candidates), (uint8_t)to, (uint8_t)promotion };
+            if (!legal(candidate)) continue;
+            if (found) return SanError::AMBIGUOUS;
+            move = candidate;
+            found = true;
+        }
+        return found ? SanError::NONE : SanError::ILLEGAL;
+    }
+
+    // "e2e4", "e7e8q", rokade sebagai langkah raja ("e1g1")
+    static void append_uci(const Move &move, std::string &out) {
+        out += char('a' + move.from % 8);
+        out += char('1' + move.from / 8);
+        out += char('a' + move.to % 8);
+        out += char('1' + move.to / 8);
+        if (move.promotion != NO_PIECE) out += "pnbrqk"[move.promotion];
+    }
+
+    bool is_capture(const Move &move) const {
+        return squares[move.to] != NO_PIECE || (squares[move.from] == PAWN && move.to == ep);
+    }
+
+    // jalankan langkah legal (dari parse_san)
+    void make(const Move &move) {
+        Color us = side, them = Color(side ^ 1);
+        int piece = squares[move.from];
+        int captured = squares[move.to];
+
+        halfmove++;
+        if (captured != NO_PIECE) {
+            remove(them, captured, move.to);
+            halfmove = 0;
+        }
+        if (piece == PAWN) {
+            halfmove = 0;
+            if (move.to == ep) remove(them, PAWN, move.to ^ 8);
+        }
+
+        remove(us, piece, move.from);
+        put(us, move.promotion != NO_PIECE ? move.promotion : piece, move.to);
+
+        if (piece == KING && std::abs(move.to - move.from) == 2) {
+            int rook_from = move.to > move.from ? move.from + 3 : move.from - 4;
+            int rook_to = move.to > move.from ? move.from + 1 : move.from - 1;
+            remove(us, ROOK, rook_from);
+            put(us, ROOK, rook_to);
+        }
+
+        ep = piece == PAWN && std::abs(move.to - move.from) == 16 ? (move.from + move.to) / 2 : -1;
+        castling &= castling_kept(move.from) & castling_kept(move.to);
+        if (us == BLACK) fullmove++;
+        side = them;
+    }
+
+private:
+    void clear() {
+        for (auto &color : pieces) {
+            for (Bitboard &b : color) b = 0;
+        }
+        colors[WHITE] = colors[BLACK] = 0;
+        for (uint8_t &square : squares) square = NO_PIECE;
+        side = WHITE;
+        castling = 0;
+        ep = -1;
+        halfmove = 0;
+        fullmove = 1;
+    }
+
+    void put(int color, int piece, int square) {
+        pieces[color][piece] |= bit(square);
+        colors[color] |= bit(square);
+        squares[square] = (uint8_t)piece;
+    }
+
+    void remove(int color, int piece, int square) {
+        pieces[color][piece] &= ~bit(square);
+        colors[color] &= ~bit(square);
+        squares[square] = NO_PIECE;
+    }
+
+    static int piece_from_char(char c) {
+        switch (c | 0x20) {  // huruf kecil
+        case 'p': return PAWN;
+        case 'n': return KNIGHT;
+        case 'b': return BISHOP;
+        case 'r': return ROOK;
+        case 'q': return QUEEN;
+        case 'k': return KING;
+        default: return NO_PIECE;
+        }
+    }
+
+    static bool parse_number(std::string_view s, int &out) {
+        if (s.empty() || s.size() > 6) return false;
+        out = 0;
+        for (char c : s) {
+            if (c < '0' || c > '9') return false;
+            out = out * 10 + (c - '0');
+        }
+        return true;
+    }
+
+    // hak rokade yang tetap ada setelah bidak pergi dari / ditangkap di square
+    static unsigned castling_kept(int square) {
+        switch (square) {
+        case 0: return ~(unsigned)WHITE_OOO;
+        case 4: return ~(unsigned)(WHITE_OO | WHITE_OOO);
+        case 7: return ~(unsigned)WHITE_OO;
+        case 56: return ~(unsigned)BLACK_OOO;
+        case 60: return ~(unsigned)(BLACK_OO | BLACK_OOO);
+        case 63: return ~(unsigned)BLACK_OO;
+        default: return ~0u;
+        }
+    }
+
+    // square asal bidak jenis piece (bukan pion) yang bisa ke square to
+    Bitboard attacks_to(int piece, int to) const {
+        const detail::AttackTables &t = detail::tables();
+        switch (piece) {
+        case KNIGHT: return t.knight[to];
+        case BISHOP: return bishop_attacks(to, occupied());
+        case ROOK: return rook_attacks(to, occupied());
+        case QUEEN: return bishop_attacks(to, occupied()) | rook_attacks(to, occupied());
+        default: return t.king[to];
+        }
+    }
+
+    // langkah pseudo-legal tidak meninggalkan raja sendiri dalam skak
+    bool legal(const Move &move) const {
+        Color them = Color(side ^ 1);
+        Bitboard occupied_after = (occupied() ^ bit(move.from)) | bit(move.to);
+        Bitboard enemies = colors[them] & ~bit(move.to);
+        if (squares[move.from] == PAWN && move.to == ep) {
+            occupied_after ^= bit(move.to ^ 8);
+            enemies &= ~bit(move.to ^ 8);
+        }
+        int king = squares[move.from] == KING ? move.to : king_square(side);
+        return !(attackers(king, them, occupied_after) & enemies);
+    }
+
+    bool ep_capturable() const {
+        Bitboard pawns = detail::tables().pawn[side ^ 1][ep] & pieces[side][PAWN];
+        while (pawns) {
+            if (legal(Move{ (uint8_t)pop_lsb(pawns), (uint8_t)ep, NO_PIECE })) return true;
+        }
+        return false;
+    }
+
+    SanError parse_castle(bool queen_side, Move &move) const {
+        Color them = Color(side ^ 1);
+        int king = side == WHITE ? 4 : 60;
+        unsigned right = side == WHITE ? (queen_side ? WHITE_OOO : WHITE_OO) : (queen_side ? BLACK_OOO : BLACK_OO);
+        int rook = queen_side ? king - 4 : king + 3;
+        if (!(castling & right) || !(pieces[side][KING] & bit(king)) || !(pieces[side][ROOK] & bit(rook))) {
+            return SanError::ILLEGAL;
+        }
+
+        // square di antara raja dan benteng kosong, raja tidak lewat square yang diserang
+        Bitboard between = queen_side ? bit(king - 1) | bit(king - 2) | bit(king - 3) : bit(king + 1) | bit(king + 2);
+        if (occupied() & between) return SanError::ILLEGAL;
+        int step = queen_side ? -1 : 1;
+        for (int square = king; square != king + 3 * step; square += step) {
+            if (attackers(square, them, occupied())) return SanError::ILLEGAL;
+        }
+
+        move = Move{ (uint8_t)king, (uint8_t)(king + 2 * step), NO_PIECE };
+        return SanError::NONE;
+    }
+};
+
+} // namespace chess
@@ -0,0 +1,272 @@
+#pragma once
+
+// CSV writer dengan buffer sendiri: row diformat langsung ke buffer beberapa MB
+// lalu ditulis dengan satu write() besar, tanpa alokasi per field.
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+static const size_t CSV_BUFFER_BYTES = 4 << 20;  // ukuran buffer output
+static const size_t CSV_DIRECT_ALIGN = 4096;     // alignment buffer & offset untuk O_DIRECT
+
+// sama dengan ofstream mode teks sebelumnya: CRLF di Windows
+#ifdef _WIN32
+static const std::string_view CSV_NEWLINE = "\r\n";
+#else
+static const std::string_view CSV_NEWLINE = "\n";
+#endif
+
+struct CSVWriter {
+    fs::path path;
+    bool header_written = false;
+
+    // resume_bytes > 0: CSV dipotong ke panjang checkpoint lalu dilanjutkan.
+    // direct_io: tulis dengan O_DIRECT (Linux), melewati page cache.
+    CSVWriter(const fs::path &filename, uintmax_t resume_bytes = 0, bool direct_io = false) : path(filename) {
+        if (resume_bytes > 0) {
+            if (!fs::exists(filename) || fs::file_size(filename) < resume_bytes) {
+                throw std::runtime_error("CSV file is shorter than checkpoint");
+            }
+            fs::resize_file(filename, resume_bytes);
+            header_written = true;
+        }
+
+#ifdef _WIN32
+        fd = _wopen(filename.c_str(), _O_WRONLY | _O_CREAT | _O_BINARY | (resume_bytes > 0 ? 0 : _O_TRUNC),
+                    _S_IREAD | _S_IWRITE);
+        direct_io = false;
+#else
+        int flags = O_WRONLY | O_CREAT | (resume_bytes > 0 ? 0 : O_TRUNC);
+#ifdef O_DIRECT
+        if (direct_io) {
+            fd = ::open(filename.c_str(), flags | O_DIRECT, 0644);
+            if (fd < 0) direct_io = false;  // filesystem tidak mendukung O_DIRECT (mis. tmpfs)
+        }
+#else
+        direct_io = false;
+#endif
+        if (fd < 0) fd = ::open(filename.c_str(), flags, 0644);
+#endif
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open CSV file");
+        }
+
+        direct = direct_io;
+        file_offset = resume_bytes;
+
+        // O_DIRECT hanya menerima offset kelipatan block: mulai dari block terakhir
+        // dan muat ulang sisa byte-nya ke buffer
+        size_t head = direct ? file_offset % CSV_DIRECT_ALIGN : 0;
+        allocate(CSV_BUFFER_BYTES);
+        if (head > 0) {
+            file_offset -= head;
+            if (!read_at(file_offset, buffer, head)) {
+                throw std::runtime_error("Cannot read CSV tail for resume");
+            }
+            size = head;
+        }
+        seek(file_offset);
+    }
+
+    CSVWriter(const CSVWriter &) = delete;
+    CSVWriter &operator=(const CSVWriter &) = delete;
+
+    ~CSVWriter() {
+        if (fd >= 0) {
+            try {
+                flush();
+            } catch (...) {
+            }
+            close_fd();
+        }
+    }
+
+    bool direct_io() const {
+        return direct;
+    }
+
+    // panjang CSV termasuk row yang masih di buffer
+    uintmax_t bytes() const {
+        return file_offset + size;
+    }
+
+    // header tanpa quote, dipisah koma
+    void write_header(const std::string_view *names, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            reserve(names[i].size() + 2);
+            append(names[i].data(), names[i].size());
+            if (i + 1 < count) buffer[size++] = ',';
+        }
+        end_line();
+        header_written = true;
+    }
+
+    // setiap field diberi quote, double quote di dalamnya digandakan
+    void write_row(const std::string_view *fields, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            std::string_view value = fields[i];
+            reserve(value.size() + 3);  // cukup untuk field tanpa quote di dalamnya
+
+            buffer[size++] = '"';
+            const char *p = value.data();
+            const char *end = p + value.size();
+            while (p < end) {
+                const char *quote = (const char *)memchr(p, '"', end - p);
+                size_t span = (quote ? quote : end) - p;
+                reserve(span + 4);
+                append(p, span);
+                if (!quote) break;
+                buffer[size++] = '"';
+                buffer[size++] = '"';
+                p = quote + 1;
+            }
+            buffer[size++] = '"';
+            if (i + 1 < count) buffer[size++] = ',';
+        }
+        end_line();
+    }
+
+    // tulis isi buffer ke file; setelah return, bytes() byte pertama ada di file
+    void flush() {
+        if (!direct) {
+            write_all(buffer, size);
+            file_offset += size;
+            size = 0;
+            return;
+        }
+
+        // bagian yang penuh per block ditulis biasa, sisanya ditulis dengan padding
+        // lalu file dipotong; sisa itu tetap di buffer dan ditimpa di flush berikutnya
+        size_t aligned = size - size % CSV_DIRECT_ALIGN;
+        write_all(buffer, aligned);
+        file_offset += aligned;
+        size -= aligned;
+        memmove(buffer, buffer + aligned, size);
+
+        if (size > 0) {
+            size_t padded = CSV_DIRECT_ALIGN;
+            memset(buffer + size, 0, padded - size);
+            write_all(buffer, padded);
+            truncate_to(file_offset + size);
+            seek(file_offset);
+        }
+    }
+
+private:
+#ifdef _WIN32
+    using ssize_type = int;
+#else
+    using ssize_type = ssize_t;
+#endif
+
+    int fd = -1;
+    bool direct = false;
+    uint64_t file_offset = 0;  // offset file awal buffer
+    std::vector<char> storage;
+    char *buffer = nullptr;
+    size_t size = 0;
+    size_t capacity = 0;
+
+    void allocate(size_t new_capacity) {
+        // buffer di-align supaya bisa dipakai langsung oleh O_DIRECT
+        std::vector<char> next(new_capacity + CSV_DIRECT_ALIGN);
+        char *aligned = next.data() + (CSV_DIRECT_ALIGN - (uintptr_t)next.data() % CSV_DIRECT_ALIGN) % CSV_DIRECT_ALIGN;
+        if (size > 0) memcpy(aligned, buffer, size);
+        storage.swap(next);
+        buffer = aligned;
+        capacity = new_capacity;
+    }
+
+    // pastikan ada ruang n byte; field yang lebih besar dari buffer membuat buffer tumbuh
+    void reserve(size_t n) {
+        if (capacity - size >= n) return;
+        flush();
+        if (capacity - size < n) {
+            size_t new_capacity = capacity;
+            while (new_capacity - size < n) new_capacity *= 2;
+            allocate(new_capacity);
+        }
+    }
+
+    void end_line() {
+        reserve(CSV_NEWLINE.size());
+        append(CSV_NEWLINE.data(), CSV_NEWLINE.size());
+    }
+
+    void append(const char *data, size_t n) {
+        memcpy(buffer + size, data, n);
+        size += n;
+    }
+
+    void write_all(const char *data, size_t n) {
+        while (n > 0) {
+            size_t chunk = n < (1u << 30) ? n : (1u << 30);
+#ifdef _WIN32
+            ssize_type written = _write(fd, data, (unsigned)chunk);
+#else
+            ssize_type written = ::write(fd, data, chunk);
+#endif
+            if (written <= 0) {
+                throw std::runtime_error("Cannot write CSV file");
+            }
+            data += written;
+            n -= written;
+        }
+    }
+
+    bool read_at(uint64_t offset, char *data, size_t n) {
+#ifdef _WIN32
+        (void)offset; (void)data; (void)n;
+        return false;
+#else
+        // O_DIRECT butuh read yang juga aligned, baca lewat descriptor biasa
+        int reader = ::open(path.c_str(), O_RDONLY);
+        if (reader < 0) return false;
+        bool ok = ::pread(reader, data, n, offset) == (ssize_type)n;
+        ::close(reader);
+        return ok;
+#endif
+    }
+
+    void seek(uint64_t offset) {
+#ifdef _WIN32
+        _lseeki64(fd, offset, SEEK_SET);
+#else
+        ::lseek(fd, offset, SEEK_SET);
+#endif
+    }
+
+    void truncate_to(uint64_t length) {
+#ifdef _WIN32
+        _chsize_s(fd, length);
+#else
+        if (::ftruncate(fd, length) != 0) {
+            throw std::runtime_error("Cannot truncate CSV file");
+        }
+#endif
+    }
+
+    void close_fd() {
+#ifdef _WIN32
+        _close(fd);
+#else
+        ::close(fd);
+#endif
+        fd = -1;
+    }
+};
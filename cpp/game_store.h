@@ -0,0 +1,815 @@
+#pragma once
+
+// Game store: hasil parsing dump disimpan sekali ke satu file biner, lalu
+// dibaca ulang lewat mmap tanpa dekompresi dan parsing teks PGN lagi.
+//
+// Isi file (little-endian): StoreHeader lalu section rata 64 byte:
+//   - kolom header lebar tetap, satu array per kolom: Elo, rating diff, base /
+//     increment time control (int16), tanggal (yyyymmdd), id game Lichess
+//     (8 karakter di uint64), dan id dictionary uint16 untuk Event, Result,
+//     title, TimeControl, Termination, ECO, Opening
+//   - nama pemain (white lalu black per game) dan langkah 16 bit
+//     chess::Move::pack(), masing-masing dengan array offset per game
+//   - index Site: nomor game terurut menurut id Lichess, untuk binary search
+//   - dictionary semua kolom dictionary
+//   - index sekunder: roaring bitmap per ECO, per bucket Elo (putih / hitam)
+//     dan per tanggal, plus pasangan (hash nama pemain, game) terurut
+// Filter / agregasi cukup membaca kolom yang dipakai, query sempit cukup
+// mengiris index, dan game ke-i atau link Lichess bisa diakses langsung.
+//
+// Nilai yang tidak ada atau bukan angka disimpan sebagai STORE_MISSING /
+// STORE_MISSING_ID / 0, Elo "?" (rating belum diketahui) sebagai STORE_UNKNOWN. Langkah dianggap dari posisi awal (dump rated standard
+// tidak punya tag FEN); game yang replay-nya berhenti di SAN ilegal / ambigu
+// ditandai STORE_TRUNCATED dan langkahnya berhenti sebelum SAN itu. Movetext
+// yang tidak bisa dibaca (token bukan SAN, variant lain, FEN rusak) ditandai
+// STORE_UNREPLAYED, bukan terpotong.
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "chess_board.h"
+#include "mapped_file.h"
+#include "pgn_filter.h"
+#include "roaring.h"
+
+namespace fs = std::filesystem;
+
+static const char STORE_MAGIC[8] = { 'C', 'H', 'S', 'T', 'O', 'R', 'E', '1' };
+static const uint32_t STORE_VERSION = 2;  // 2: index sekunder
+static const size_t STORE_ALIGN = 64;
+static const size_t STORE_BUFFER = 1 << 20;  // buffer per section saat menulis
+static const int STORE_ELO_BUCKET = 100;      // lebar bucket index Elo
+
+static const int16_t STORE_MISSING = INT16_MIN;      // kolom int16 tanpa nilai
+static const int16_t STORE_UNKNOWN = INT16_MIN + 1;  // kolom int16 berisi "?"
+static const uint16_t STORE_MISSING_ID = 0xFFFF;  // kolom dictionary tanpa nilai
+static const uint8_t STORE_TRUNCATED = 1;        // flag: langkah berhenti di SAN ilegal / ambigu
+static const uint8_t STORE_UNREPLAYED = 2;       // flag: movetext tidak bisa di-replay sampai habis
+
+static const std::string_view LICHESS_URL = "https://lichess.org/";
+
+enum StoreSection {
+    // int16
+    SECTION_WHITE_ELO,
+    SECTION_BLACK_ELO,
+    SECTION_WHITE_DIFF,
+    SECTION_BLACK_DIFF,
+    SECTION_TC_BASE,
+    SECTION_TC_INCREMENT,
+    // uint16 id dictionary
+    SECTION_EVENT,
+    SECTION_RESULT,
+    SECTION_WHITE_TITLE,
+    SECTION_BLACK_TITLE,
+    SECTION_TIME_CONTROL,
+    SECTION_TERMINATION,
+    SECTION_ECO,
+    SECTION_OPENING,
+    // lainnya
+    SECTION_DATE,            // uint32 yyyymmdd
+    SECTION_SITE,            // uint64 id game
+    SECTION_FLAGS,           // uint8
+    SECTION_PLAYER_OFFSETS,  // uint64 [2 * games + 1]
+    SECTION_PLAYERS,         // char
+    SECTION_MOVE_OFFSETS,    // uint64 [games + 1], dalam jumlah langkah
+    SECTION_MOVES,           // uint16
+    SECTION_SITE_INDEX,      // uint32 [games]
+    SECTION_DICTIONARIES,    // per kolom dictionary: uint32 n, lalu n x (uint16 len, teks)
+    // index bitmap: uint32 n, uint32 0, n x StoreIndexEntry, lalu roaring bitmap
+    SECTION_WHITE_ELO_INDEX, // key = elo_bucket(WhiteElo)
+    SECTION_BLACK_ELO_INDEX,
+    SECTION_ECO_INDEX,       // key = id dictionary ECO
+    SECTION_DATE_INDEX,      // key = yyyymmdd
+    SECTION_PLAYER_INDEX,    // uint64 (player_hash << 32 | game) terurut, white dan black
+    SECTION_COUNT
+};
+
+constexpr int FIRST_INT16_SECTION = SECTION_WHITE_ELO;
+constexpr int FIRST_DICT_SECTION = SECTION_EVENT;
+constexpr int DICT_SECTION_COUNT = SECTION_DATE - SECTION_EVENT;
+
+inline bool int16_section(int section) {
+    return section >= FIRST_INT16_SECTION && section < FIRST_DICT_SECTION;
+}
+
+inline bool dict_section(int section) {
+    return section >= FIRST_DICT_SECTION && section < SECTION_DATE;
+}
+
+inline bool bitmap_index_section(int section) {
+    return section >= SECTION_WHITE_ELO_INDEX && section <= SECTION_DATE_INDEX;
+}
+
+// section yang ditulis dari memori di close(), bukan dari file sementara
+inline bool memory_section(int section) {
+    return section == SECTION_SITE_INDEX || section >= SECTION_DICTIONARIES;
+}
+
+// bucket index Elo, juga untuk Elo negatif; STORE_MISSING / STORE_UNKNOWN tidak diindex
+inline uint32_t elo_bucket(int16_t elo) {
+    return (uint32_t)(elo - INT16_MIN) / STORE_ELO_BUCKET;
+}
+
+// Elo terkecil di bucket, bucket mencakup STORE_ELO_BUCKET nilai
+inline int elo_bucket_low(uint32_t bucket) {
+    return (int)bucket * STORE_ELO_BUCKET + INT16_MIN;
+}
+
+// FNV-1a 64 bit, 32 bit atas untuk index nama pemain
+inline uint32_t player_hash(std::string_view name) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : name) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return (uint32_t)(hash >> 32);
+}
+
+struct StoreSectionEntry {
+    uint64_t offset = 0;
+    uint64_t bytes = 0;
+};
+
+struct StoreIndexEntry {
+    uint32_t key = 0;
+    uint32_t reserved = 0;
+    uint64_t offset = 0;  // dari awal section
+    uint64_t bytes = 0;
+};
+
+struct StoreHeader {
+    char magic[8] = {};
+    uint32_t version = 0;
+    uint32_t section_count = 0;
+    uint64_t games = 0;
+    uint64_t plies = 0;
+    StoreSectionEntry sections[SECTION_COUNT];
+};
+
+// Tag PGN yang ada di store, urutannya sama dengan field header generate_data
+enum StoreTag {
+    STORE_TAG_EVENT,
+    STORE_TAG_SITE,
+    STORE_TAG_DATE,
+    STORE_TAG_WHITE,
+    STORE_TAG_BLACK,
+    STORE_TAG_WHITE_TITLE,
+    STORE_TAG_BLACK_TITLE,
+    STORE_TAG_WHITE_ELO,
+    STORE_TAG_BLACK_ELO,
+    STORE_TAG_RESULT,
+    STORE_TAG_WHITE_DIFF,
+    STORE_TAG_BLACK_DIFF,
+    STORE_TAG_TIME_CONTROL,
+    STORE_TAG_TERMINATION,
+    STORE_TAG_ECO,
+    STORE_TAG_OPENING,
+    STORE_TAG_COUNT
+};
+
+static const std::array<std::string_view, STORE_TAG_COUNT> STORE_TAGS = {
+    "Event", "Site", "Date", "White", "Black", "WhiteTitle", "BlackTitle", "WhiteElo", "BlackElo", "Result",
+    "WhiteRatingDiff", "BlackRatingDiff", "TimeControl", "Termination", "ECO", "Opening"
+};
+
+// section kolom lebar tetap untuk tag, -1 untuk Site / Date / nama pemain
+static const std::array<int, STORE_TAG_COUNT> STORE_TAG_SECTION = {
+    SECTION_EVENT, -1, -1, -1, -1, SECTION_WHITE_TITLE, SECTION_BLACK_TITLE, SECTION_WHITE_ELO, SECTION_BLACK_ELO,
+    SECTION_RESULT, SECTION_WHITE_DIFF, SECTION_BLACK_DIFF, SECTION_TIME_CONTROL, SECTION_TERMINATION, SECTION_ECO,
+    SECTION_OPENING
+};
+
+inline int store_tag(std::string_view name) {
+    for (int i = 0; i < STORE_TAG_COUNT; ++i) {
+        if (STORE_TAGS[i] == name) return i;
+    }
+    return -1;
+}
+
+// id game dari link Lichess atau id saja ("abcdefgh"); id 12 karakter (link
+// per pemain) dipotong ke 8. 0 jika bukan link game Lichess.
+inline uint64_t site_key(std::string_view site) {
+    if (site.rfind(LICHESS_URL, 0) == 0) site.remove_prefix(LICHESS_URL.size());
+    else if (site.rfind("http://lichess.org/", 0) == 0) site.remove_prefix(19);
+
+    size_t length = 0;
+    while (length < site.size() && std::isalnum((unsigned char)site[length])) length++;
+    if (length != 8 && length != 12) return 0;
+    if (length < site.size() && site[length] != '/' && site[length] != '#' && site[length] != '?') return 0;
+
+    uint64_t key = 0;
+    memcpy(&key, site.data(), 8);
+    return key;
+}
+
+// Penulis store: setiap section ditulis ke file sementara di sebelah output
+// selama scan, lalu digabung menjadi satu file di close(). Yang ditahan di
+// memori hanya dictionary dan index: id Site (8 byte per game), pasangan nama
+// pemain (16 byte per game) dan roaring bitmap.
+class GameStoreWriter {
+public:
+    // nilai teks satu game, seperti di tag PGN
+    struct Record {
+        std::array<std::string_view, STORE_TAG_COUNT> tags{};
+        std::string_view moves_uci;  // dipisah spasi
+        bool truncated = false;
+        bool unreplayed = false;
+    };
+
+    explicit GameStoreWriter(const fs::path &path) : path(path) {
+        for (int s = 0; s < SECTION_COUNT; ++s) {
+            if (memory_section(s)) continue;
+            spills[s].path = path.string() + ".part" + std::to_string(s);
+            spills[s].out.open(spills[s].path, std::ios::binary | std::ios::trunc);
+            if (!spills[s].out) throw std::runtime_error("Cannot create game store file");
+            spills[s].buffer.reserve(STORE_BUFFER);
+        }
+        uint64_t zero = 0;
+        put(SECTION_PLAYER_OFFSETS, zero);
+        put(SECTION_MOVE_OFFSETS, zero);
+    }
+
+    GameStoreWriter(const GameStoreWriter &) = delete;
+    GameStoreWriter &operator=(const GameStoreWriter &) = delete;
+
+    ~GameStoreWriter() {
+        for (auto &spill : spills) {
+            if (spill.out.is_open()) spill.out.close();
+            if (!spill.path.empty()) {
+                std::error_code ignored;
+                fs::remove(spill.path, ignored);
+            }
+        }
+    }
+
+    uint64_t games() const {
+        return game_count;
+    }
+
+    uint64_t plies() const {
+        return move_count;
+    }
+
+    uint64_t truncated() const {
+        return truncated_count;
+    }
+
+    uint64_t unreplayed() const {
+        return unreplayed_count;
+    }
+
+    void append(const Record &game) {
+        uint32_t id = (uint32_t)game_count;
+        for (int tag = 0; tag < STORE_TAG_COUNT; ++tag) {
+            int section = STORE_TAG_SECTION[tag];
+            if (dict_section(section)) {
+                uint16_t value = intern(section, game.tags[tag]);
+                put(section, value);
+                if (section == SECTION_ECO && value != STORE_MISSING_ID) bitmaps[SECTION_ECO_INDEX][value].add(id);
+            } else if (int16_section(section)) {
+                int16_t value = to_int16(game.tags[tag]);
+                put(section, value);
+                if ((section == SECTION_WHITE_ELO || section == SECTION_BLACK_ELO) && value > STORE_UNKNOWN) {
+                    int index = section == SECTION_WHITE_ELO ? SECTION_WHITE_ELO_INDEX : SECTION_BLACK_ELO_INDEX;
+                    bitmaps[index][elo_bucket(value)].add(id);
+                }
+            }
+        }
+
+        int16_t base = STORE_MISSING, increment = STORE_MISSING;
+        std::string_view tc = game.tags[STORE_TAG_TIME_CONTROL];
+        size_t plus_sign = tc.find('+');
+        int number;
+        if (plus_sign != std::string_view::npos) {
+            if (parse_int(tc, 0, plus_sign, number) && number >= 0 && number <= INT16_MAX) base = (int16_t)number;
+            if (parse_int(tc, plus_sign + 1, tc.size(), number) && number >= 0 && number <= INT16_MAX) increment = (int16_t)number;
+        }
+        put(SECTION_TC_BASE, base);
+        put(SECTION_TC_INCREMENT, increment);
+
+        uint32_t date = to_date(game.tags[STORE_TAG_DATE]);
+        put(SECTION_DATE, date);
+        if (date) bitmaps[SECTION_DATE_INDEX][date].add(id);
+        uint64_t site = site_key(game.tags[STORE_TAG_SITE]);
+        put(SECTION_SITE, site);
+        sites.push_back(site);
+        put(SECTION_FLAGS, (uint8_t)((game.truncated ? STORE_TRUNCATED : 0) | (game.unreplayed ? STORE_UNREPLAYED : 0)));
+        if (game.truncated) truncated_count++;
+        if (game.unreplayed) unreplayed_count++;
+
+        for (int tag : { STORE_TAG_WHITE, STORE_TAG_BLACK }) {
+            write(SECTION_PLAYERS, game.tags[tag].data(), game.tags[tag].size());
+            player_bytes += game.tags[tag].size();
+            put(SECTION_PLAYER_OFFSETS, player_bytes);
+            if (!game.tags[tag].empty()) players.push_back((uint64_t)player_hash(game.tags[tag]) << 32 | id);
+        }
+
+        std::string_view moves = game.moves_uci;
+        size_t pos = 0;
+        while (pos < moves.size()) {
+            size_t end = std::min(moves.find(' ', pos), moves.size());
+            chess::Move move;
+            if (parse_uci(moves.substr(pos, end - pos), move)) {
+                put(SECTION_MOVES, move.pack());
+                move_count++;
+            }
+            pos = end + 1;
+        }
+        put(SECTION_MOVE_OFFSETS, move_count);
+        game_count++;
+    }
+
+    // gabungkan semua section ke file output, file sementara dihapus
+    void close() {
+        if (closed) return;
+        closed = true;
+
+        StoreHeader header;
+        memcpy(header.magic, STORE_MAGIC, sizeof(STORE_MAGIC));
+        header.version = STORE_VERSION;
+        header.section_count = SECTION_COUNT;
+        header.games = game_count;
+        header.plies = move_count;
+
+        for (auto &spill : spills) {
+            if (!spill.out.is_open()) continue;
+            flush(spill);
+            spill.out.close();
+            if (!spill.out) throw std::runtime_error("Cannot write game store file");
+        }
+
+        // index Site: nomor game terurut menurut id (game tanpa id = 0 di awal)
+        std::vector<uint32_t> index(sites.size());
+        for (size_t g = 0; g < index.size(); ++g) index[g] = (uint32_t)g;
+        std::stable_sort(index.begin(), index.end(), [&](uint32_t a, uint32_t b) { return sites[a] < sites[b]; });
+        std::vector<uint64_t>().swap(sites);
+
+        std::sort(players.begin(), players.end());
+
+        std::array<std::string, SECTION_COUNT> blobs;
+        std::string &dictionaries = blobs[SECTION_DICTIONARIES];
+        for (int d = 0; d < DICT_SECTION_COUNT; ++d) {
+            uint32_t count = (uint32_t)values[d].size();
+            dictionaries.append((const char *)&count, sizeof(count));
+            for (const std::string &value : values[d]) {
+                uint16_t length = (uint16_t)value.size();
+                dictionaries.append((const char *)&length, sizeof(length));
+                dictionaries.append(value);
+            }
+        }
+        // index tanpa key (mis. tidak ada game dengan Elo) tetap ditulis: n = 0
+        for (int section = SECTION_WHITE_ELO_INDEX; section <= SECTION_DATE_INDEX; ++section) {
+            serialize_index(bitmaps[section], blobs[section]);
+        }
+        bitmaps.clear();
+
+        uint64_t offset = (sizeof(StoreHeader) + STORE_ALIGN - 1) / STORE_ALIGN * STORE_ALIGN;
+        for (int s = 0; s < SECTION_COUNT; ++s) {
+            uint64_t bytes = s == SECTION_SITE_INDEX ? index.size() * sizeof(uint32_t)
+                           : s == SECTION_PLAYER_INDEX ? players.size() * sizeof(uint64_t)
+                           : memory_section(s) ? blobs[s].size()
+                           : spills[s].bytes;
+            header.sections[s] = { offset, bytes };
+            offset = (offset + bytes + STORE_ALIGN - 1) / STORE_ALIGN * STORE_ALIGN;
+        }
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) throw std::runtime_error("Cannot open game store file");
+        out.write((const char *)&header, sizeof(header));
+
+        std::vector<char> chunk(STORE_BUFFER);
+        for (int s = 0; s < SECTION_COUNT; ++s) {
+            pad(out, header.sections[s].offset);
+            if (s == SECTION_SITE_INDEX) {
+                out.write((const char *)index.data(), (std::streamsize)(index.size() * sizeof(uint32_t)));
+            } else if (s == SECTION_PLAYER_INDEX) {
+                out.write((const char *)players.data(), (std::streamsize)(players.size() * sizeof(uint64_t)));
+            } else if (memory_section(s)) {
+                out.write(blobs[s].data(), (std::streamsize)blobs[s].size());
+            } else {
+                std::ifstream in(spills[s].path, std::ios::binary);
+                while (in) {
+                    in.read(chunk.data(), (std::streamsize)chunk.size());
+                    out.write(chunk.data(), in.gcount());
+                }
+                in.close();
+                fs::remove(spills[s].path);
+                spills[s].path.clear();
+            }
+        }
+        pad(out, offset);
+        if (!out) throw std::runtime_error("Cannot write game store file");
+    }
+
+private:
+    struct Spill {
+        fs::path path;
+        std::ofstream out;
+        std::string buffer;
+        uint64_t bytes = 0;
+    };
+
+    fs::path path;
+    std::array<Spill, SECTION_COUNT> spills;
+    std::array<std::unordered_map<std::string, uint16_t>, DICT_SECTION_COUNT> ids;
+    std::array<std::vector<std::string>, DICT_SECTION_COUNT> values;
+    std::vector<uint64_t> sites;
+    std::vector<uint64_t> players;  // (player_hash << 32) | game
+    std::map<int, std::map<uint32_t, RoaringBitmap>> bitmaps;  // section index -> key -> game
+    uint64_t game_count = 0;
+    uint64_t player_bytes = 0;
+    uint64_t move_count = 0;
+    uint64_t truncated_count = 0;
+    uint64_t unreplayed_count = 0;
+    bool closed = false;
+
+    void write(int section, const void *data, size_t n) {
+        Spill &spill = spills[section];
+        spill.buffer.append((const char *)data, n);
+        spill.bytes += n;
+        if (spill.buffer.size() >= STORE_BUFFER) flush(spill);
+    }
+
+    template <typename T>
+    void put(int section, T value) {
+        write(section, &value, sizeof(value));
+    }
+
+    void flush(Spill &spill) {
+        spill.out.write(spill.buffer.data(), (std::streamsize)spill.buffer.size());
+        spill.buffer.clear();
+        if (!spill.out) throw std::runtime_error("Cannot write game store file");
+    }
+
+    // tabel StoreIndexEntry lalu bitmap per key, urut menurut key
+    static void serialize_index(const std::map<uint32_t, RoaringBitmap> &index, std::string &out) {
+        uint32_t count = (uint32_t)index.size(), reserved = 0;
+        out.append((const char *)&count, sizeof(count));
+        out.append((const char *)&reserved, sizeof(reserved));
+        size_t table = out.size();
+        out.resize(table + index.size() * sizeof(StoreIndexEntry));
+
+        size_t i = 0;
+        for (const auto &entry : index) {
+            StoreIndexEntry item;
+            item.key = entry.first;
+            item.offset = out.size();
+            entry.second.serialize(out);
+            item.bytes = out.size() - item.offset;
+            memcpy(&out[table + i++ * sizeof(StoreIndexEntry)], &item, sizeof(item));
+        }
+    }
+
+    static void pad(std::ofstream &out, uint64_t offset) {
+        static const char zeros[STORE_ALIGN] = {};
+        uint64_t at = (uint64_t)out.tellp();
+        if (offset > at) out.write(zeros, (std::streamsize)(offset - at));
+    }
+
+    uint16_t intern(int section, std::string_view value) {
+        if (value.empty()) return STORE_MISSING_ID;
+        int d = section - FIRST_DICT_SECTION;
+        auto it = ids[d].find(std::string(value));
+        if (it != ids[d].end()) return it->second;
+        if (values[d].size() >= STORE_MISSING_ID || value.size() > UINT16_MAX) {
+            throw std::runtime_error("Game store dictionary is full for column " + std::to_string(section));
+        }
+        uint16_t id = (uint16_t)values[d].size();
+        values[d].emplace_back(value);
+        ids[d].emplace(values[d].back(), id);
+        return id;
+    }
+
+    static int16_t to_int16(std::string_view text) {
+        int number;
+        if (text == "?") return STORE_UNKNOWN;
+        if (!parse_int(text, 0, text.size(), number) || number <= STORE_UNKNOWN || number > INT16_MAX) return STORE_MISSING;
+        return (int16_t)number;
+    }
+
+    // "2025.12.01" -> 20251201, 0 jika tidak lengkap
+    static uint32_t to_date(std::string_view text) {
+        if (text.size() != 10 || text[4] != '.' || text[7] != '.') return 0;
+        uint32_t date = 0;
+        for (size_t i = 0; i < text.size(); ++i) {
+            if (i == 4 || i == 7) continue;
+            if (text[i] < '0' || text[i] > '9') return 0;
+            date = date * 10 + (text[i] - '0');
+        }
+        return date;
+    }
+
+    static bool parse_uci(std::string_view uci, chess::Move &move) {
+        if (uci.size() < 4 || uci.size() > 5) return false;
+        for (int i = 0; i < 4; ++i) {
+            char lo = i % 2 == 0 ? 'a' : '1';
+            if (uci[i] < lo || uci[i] > lo + 7) return false;
+        }
+        move.from = (uint8_t)((uci[0] - 'a') + (uci[1] - '1') * 8);
+        move.to = (uint8_t)((uci[2] - 'a') + (uci[3] - '1') * 8);
+        move.promotion = chess::NO_PIECE;
+        if (uci.size() == 5) {
+            const char *piece = uci[4] ? strchr("pnbrqk", uci[4]) : nullptr;
+            if (!piece) return false;
+            move.promotion = (uint8_t)(piece - "pnbrqk");
+        }
+        return true;
+    }
+};
+
+// Store yang di-mmap read-only. Semua pointer kolom valid selama objek hidup.
+class GameStore {
+public:
+    GameStore() = default;
+    GameStore(const GameStore &) = delete;
+    GameStore &operator=(const GameStore &) = delete;
+
+    ~GameStore() {
+        unmap();
+    }
+
+    // return false dan isi error jika file tidak bisa dibuka atau bukan store
+    bool open(const fs::path &path, std::string &error) {
+        unmap();
+        if (!map(path, error)) return false;
+
+        if (size < sizeof(StoreHeader)) return fail("file too small", error);
+        memcpy(&header, data, sizeof(header));
+        if (memcmp(header.magic, STORE_MAGIC, sizeof(STORE_MAGIC)) != 0) return fail("not a game store", error);
+        if (header.version != STORE_VERSION || header.section_count != SECTION_COUNT) {
+            return fail("unsupported game store version", error);
+        }
+
+        for (int s = 0; s < SECTION_COUNT; ++s) {
+            const StoreSectionEntry &section = header.sections[s];
+            if (section.offset % STORE_ALIGN != 0 || section.offset > size || section.bytes > size - section.offset) {
+                return fail("section " + std::to_string(s) + " out of range", error);
+            }
+            size_t expected = expected_bytes(s);
+            if (expected != SIZE_MAX && section.bytes != expected) {
+                return fail("section " + std::to_string(s) + " has wrong size", error);
+            }
+        }
+        if (player_offsets()[2 * games()] != header.sections[SECTION_PLAYERS].bytes ||
+            move_offsets()[games()] != header.plies) {
+            return fail("offset index does not match data", error);
+        }
+        for (int s = SECTION_WHITE_ELO_INDEX; s <= SECTION_DATE_INDEX; ++s) {
+            if (!check_index(s)) return fail("section " + std::to_string(s) + " has a broken index", error);
+        }
+        if (header.sections[SECTION_PLAYER_INDEX].bytes % sizeof(uint64_t) != 0) {
+            return fail("player index has wrong size", error);
+        }
+        return load_dictionaries(error);
+    }
+
+    uint64_t games() const {
+        return header.games;
+    }
+
+    uint64_t plies() const {
+        return header.plies;
+    }
+
+    uint64_t bytes() const {
+        return size;
+    }
+
+    uint64_t section_bytes(int section) const {
+        return header.sections[section].bytes;
+    }
+
+    template <typename T>
+    const T *column(int section) const {
+        return (const T *)(data + header.sections[section].offset);
+    }
+
+    const int16_t *int16_column(int section) const {
+        return column<int16_t>(section);
+    }
+
+    const uint16_t *dict_column(int section) const {
+        return column<uint16_t>(section);
+    }
+
+    const std::vector<std::string_view> &dictionary(int section) const {
+        return dictionaries[section - FIRST_DICT_SECTION];
+    }
+
+    std::string_view dict_value(int section, uint64_t game) const {
+        uint16_t id = dict_column(section)[game];
+        const auto &values = dictionary(section);
+        return id < values.size() ? values[id] : std::string_view();
+    }
+
+    const uint32_t *dates() const {
+        return column<uint32_t>(SECTION_DATE);
+    }
+
+    const uint64_t *sites() const {
+        return column<uint64_t>(SECTION_SITE);
+    }
+
+    const uint8_t *flags() const {
+        return column<uint8_t>(SECTION_FLAGS);
+    }
+
+    const uint64_t *player_offsets() const {
+        return column<uint64_t>(SECTION_PLAYER_OFFSETS);
+    }
+
+    const uint64_t *move_offsets() const {
+        return column<uint64_t>(SECTION_MOVE_OFFSETS);
+    }
+
+    std::string_view player(uint64_t game, chess::Color color) const {
+        const uint64_t *offsets = player_offsets() + 2 * game + color;
+        return std::string_view(column<char>(SECTION_PLAYERS) + offsets[0], offsets[1] - offsets[0]);
+    }
+
+    // langkah game (chess::Move::pack), n diisi jumlahnya
+    const uint16_t *moves(uint64_t game, size_t &n) const {
+        const uint64_t *offsets = move_offsets() + game;
+        n = offsets[1] - offsets[0];
+        return column<uint16_t>(SECTION_MOVES) + offsets[0];
+    }
+
+    // nomor game dari link Lichess atau id game, -1 jika tidak ada
+    int64_t find_site(std::string_view site) const {
+        uint64_t key = site_key(site);
+        if (!key) return -1;
+        const uint32_t *index = column<uint32_t>(SECTION_SITE_INDEX);
+        const uint64_t *keys = sites();
+        const uint32_t *it = std::lower_bound(index, index + games(), key,
+                                              [&](uint32_t game, uint64_t k) { return keys[game] < k; });
+        return it != index + games() && keys[*it] == key ? (int64_t)*it : -1;
+    }
+
+    // jumlah bitmap di section index, masing-masing dengan key naik
+    size_t index_size(int section) const {
+        uint32_t count;
+        memcpy(&count, column<char>(section), sizeof(count));
+        return count;
+    }
+
+    const StoreIndexEntry &index_entry(int section, size_t i) const {
+        return *(const StoreIndexEntry *)(column<char>(section) + 8 + i * sizeof(StoreIndexEntry));
+    }
+
+    bool index_bitmap(int section, size_t i, RoaringBitmap &out) const {
+        const StoreIndexEntry &entry = index_entry(section, i);
+        return out.deserialize(column<char>(section) + entry.offset, entry.bytes);
+    }
+
+    // game dengan pemain bernama name (putih atau hitam), ditambahkan ke out
+    void find_player(std::string_view name, RoaringBitmap &out) const {
+        const uint64_t *index = column<uint64_t>(SECTION_PLAYER_INDEX);
+        const uint64_t *end = index + header.sections[SECTION_PLAYER_INDEX].bytes / sizeof(uint64_t);
+        uint64_t key = (uint64_t)player_hash(name) << 32;
+        for (const uint64_t *it = std::lower_bound(index, end, key); it != end && (*it >> 32) == key >> 32; ++it) {
+            uint32_t game = (uint32_t)*it;
+            if (game < games() && (player(game, chess::WHITE) == name || player(game, chess::BLACK) == name)) {
+                out.add(game);
+            }
+        }
+    }
+
+    // Teks tag seperti di PGN (ditambahkan ke out). false jika tag tidak ada.
+    // Rating diff >= 0 ditulis dengan "+" seperti di dump Lichess ("+0").
+    bool append_tag(int tag, uint64_t game, std::string &out) const {
+        int section = STORE_TAG_SECTION[tag];
+        if (dict_section(section)) {
+            if (dict_column(section)[game] == STORE_MISSING_ID) return false;
+            out += dict_value(section, game);
+            return true;
+        }
+        if (int16_section(section)) {
+            int16_t value = int16_column(section)[game];
+            if (value == STORE_MISSING) return false;
+            if (value == STORE_UNKNOWN) {
+                out += '?';
+                return true;
+            }
+            if (value >= 0 && (tag == STORE_TAG_WHITE_DIFF || tag == STORE_TAG_BLACK_DIFF)) out += '+';
+            out += std::to_string(value);
+            return true;
+        }
+
+        char buffer[16];
+        switch (tag) {
+        case STORE_TAG_SITE: {
+            uint64_t key = sites()[game];
+            if (!key) return false;
+            out += LICHESS_URL;
+            out.append((const char *)&key, 8);
+            return true;
+        }
+        case STORE_TAG_DATE: {
+            uint32_t date = dates()[game];
+            if (!date) return false;
+            snprintf(buffer, sizeof(buffer), "%04u.%02u.%02u", date / 10000, date / 100 % 100, date % 100);
+            out += buffer;
+            return true;
+        }
+        case STORE_TAG_WHITE:
+        case STORE_TAG_BLACK: {
+            std::string_view name = player(game, tag == STORE_TAG_WHITE ? chess::WHITE : chess::BLACK);
+            out += name;
+            return !name.empty();
+        }
+        default:
+            return false;
+        }
+    }
+
+private:
+    StoreHeader header;
+    MappedFile mapped;
+    const char *data = nullptr;
+    size_t size = 0;
+    std::array<std::vector<std::string_view>, DICT_SECTION_COUNT> dictionaries;
+
+    bool fail(const std::string &message, std::string &error) {
+        error = message;
+        unmap();
+        return false;
+    }
+
+    // ukuran section yang ditentukan jumlah game, SIZE_MAX jika bebas
+    size_t expected_bytes(int section) const {
+        uint64_t n = header.games;
+        if (int16_section(section) || dict_section(section)) return n * 2;
+        switch (section) {
+        case SECTION_DATE: return n * sizeof(uint32_t);
+        case SECTION_SITE: return n * sizeof(uint64_t);
+        case SECTION_FLAGS: return n;
+        case SECTION_PLAYER_OFFSETS: return (2 * n + 1) * sizeof(uint64_t);
+        case SECTION_MOVE_OFFSETS: return (n + 1) * sizeof(uint64_t);
+        case SECTION_MOVES: return header.plies * sizeof(uint16_t);
+        case SECTION_SITE_INDEX: return n * sizeof(uint32_t);
+        default: return SIZE_MAX;
+        }
+    }
+
+    // tabel index muat di section dan setiap bitmap ada di dalamnya
+    bool check_index(int section) const {
+        uint64_t bytes = header.sections[section].bytes;
+        if (bytes < 8) return false;
+        uint64_t count = index_size(section);
+        if (count > (bytes - 8) / sizeof(StoreIndexEntry)) return false;
+        for (size_t i = 0; i < count; ++i) {
+            const StoreIndexEntry &entry = index_entry(section, i);
+            if (entry.offset > bytes || entry.bytes > bytes - entry.offset) return false;
+        }
+        return true;
+    }
+
+    bool load_dictionaries(std::string &error) {
+        const char *p = column<char>(SECTION_DICTIONARIES);
+        const char *end = p + header.sections[SECTION_DICTIONARIES].bytes;
+        for (auto &values : dictionaries) {
+            uint32_t count;
+            if (end - p < (ptrdiff_t)sizeof(count)) return fail("dictionary truncated", error);
+            memcpy(&count, p, sizeof(count));
+            p += sizeof(count);
+            values.clear();
+            for (uint32_t i = 0; i < count; ++i) {
+                uint16_t length;
+                if (end - p < (ptrdiff_t)sizeof(length)) return fail("dictionary truncated", error);
+                memcpy(&length, p, sizeof(length));
+                p += sizeof(length);
+                if (end - p < length) return fail("dictionary truncated", error);
+                values.emplace_back(p, length);
+                p += length;
+            }
+        }
+        return true;
+    }
+
+    bool map(const fs::path &path, std::string &error) {
+        if (!mapped.open(path, error)) return false;
+        data = mapped.data();
+        size = mapped.size();
+        return true;
+    }
+
+    void unmap() {
+        mapped.close();
+        data = nullptr;
+        size = 0;
+    }
+};
@@ -4,14 +4,42 @@
 #include <vector>
 #include <string>
 #include <sstream>
-#include <unordered_map>
-#include <regex>
+#include <array>
 #include <chrono>
 #include <iomanip>
 #include <filesystem>
+#include <algorithm>
+#include <climits>
+#include <cctype>
+#include <cstring>
+#include <string_view>
+#include <map>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+
+#include "csv_writer.h"
+#include "arrow_writer.h"
+#include "pgn_filter.h"
+#include "reservoir.h"
+#include "chess_board.h"
+#include "opening_tree.h"
+#include "player_table.h"
+#include "game_store.h"
+#include "npy_writer.h"
+#include "pgn_scan.h"
+#include "pgn_reader.h"
+#include "movetext.h"
+#include "arena.h"
+#include "mapped_file.h"
 
 #ifdef _WIN32
 #include <windows.h>
+#include <fcntl.h>
+#include <io.h>
 #endif
 
 
@@ -21,40 +49,171 @@ namespace fs = std::filesystem;
 
 static const int games_to_read = 100000;  // jumlah game yang ingin dilihat
 static const size_t  TOTAL_GAMES = 94847276;
-static const size_t  BATCH_SIZE = 5000;
+static const size_t  BATCH_SIZE = 5000;  // row CSV per flush ke disk
 static const size_t  LOG_CHECKPOINT = 20000;
+static const size_t  BATCH_BYTES = 8 << 20;  // ukuran teks PGN per batch worker
+static const size_t  CHECKPOINT_GAMES = 1000000;  // simpan posisi resume tiap N game
+static const size_t  RANGE_BYTES = 32 << 20;  // minimal teks per range frame yang didekompres paralel
+static const int     MATERIAL_PLIES = 10;  // kolom material: selisih material tiap N ply
+static const int     TREE_PLIES = 12;  // opening tree: posisi sampai ply ke-N
+static const size_t  TREE_MEMORY_MB = 1024;  // budget memori satu job opening tree
+static const size_t  PLAYER_MEMORY_MB = 1024;  // budget memori satu job players
+static const int     NPY_PLIES = 256;  // format npy: token per game (padding / dipotong)
+static const size_t  NPY_SHARD_ROWS = 65536;  // format npy: row per shard
 
 constexpr int MIN_ELO = 2200;
 
+// filter default: blitz (base 3-5 menit), kedua pemain >= MIN_ELO
+static const std::string DEFAULT_FILTER = "WhiteElo >= " + std::to_string(MIN_ELO) + " && BlackElo >= "
+                                          + std::to_string(MIN_ELO) + " && base in [180,300]";
+
 fs::path FILE_NAME = "cpp_lichess_blitz_elo" + std::to_string(MIN_ELO) + "_100k.csv";
 fs::path BASE_PATH = "C:/Users/gagah/Documents/Portofolios/Chess-analysis";
 fs::path SOURCE_PATH = BASE_PATH / "lichess_db_standard_rated_2025-12.pgn.zst";
 fs::path OUTPUT_PATH = BASE_PATH / "data" / FILE_NAME;
+fs::path CHECKPOINT_PATH = fs::path(OUTPUT_PATH).replace_extension(".checkpoint");
+fs::path FRAME_INDEX_PATH = SOURCE_PATH.string() + ".frames";
+
+// Slot record per game, urutan slot = urutan kolom CSV
+enum Field {
+    FIELD_UNKNOWN = -1,
+    FIELD_EVENT,
+    FIELD_SITE,
+    FIELD_DATE,
+    FIELD_WHITE,
+    FIELD_BLACK,
+    FIELD_WHITE_TITLE,
+    FIELD_BLACK_TITLE,
+    FIELD_WHITE_ELO,
+    FIELD_BLACK_ELO,
+    FIELD_RESULT,
+    FIELD_WHITE_RATING_DIFF,
+    FIELD_BLACK_RATING_DIFF,
+    FIELD_TIME_CONTROL,
+    FIELD_TERMINATION,
+    FIELD_ECO,
+    FIELD_OPENING,
+    // hasil parsing movetext, bukan tag PGN
+    FIELD_WHITE_N_MOVES,
+    FIELD_BLACK_N_MOVES,
+    FIELD_PLAYER_N_MOVES,
+    FIELD_MOVES,
+    // hasil replay di papan bitboard, hanya dihitung untuk job yang memilihnya
+    FIELD_MOVES_UCI,
+    FIELD_FINAL_FEN,
+    FIELD_MATERIAL,
+    FIELD_WHITE_CAPTURES,
+    FIELD_BLACK_CAPTURES,
+    FIELD_WHITE_CHECKS,
+    FIELD_BLACK_CHECKS,
+    FIELD_REPLAY_ERROR,
+    // anotasi [%clk] / [%eval] dari komentar movetext, hanya untuk job yang memilihnya
+    FIELD_CLOCKS,
+    FIELD_MOVE_TIMES,
+    FIELD_EVALS,
+    FIELD_MAX_EVAL_SWING,
+    FIELD_WHITE_LOW_CLOCK_MOVES,
+    FIELD_BLACK_LOW_CLOCK_MOVES,
+    FIELD_COUNT
+};
 
-using Schema = std::vector<std::pair<std::string, std::string>>;
-const Schema CSV_SCHEMA = {
-    {"Event", "event"},
-    {"Site", "link"},
-    {"Date", "date"},
-    {"White", "white"},
-    {"Black", "black"},
-    {"WhiteTitle", "white_titled"},
-    {"BlackTitle", "black_titled"},
-    {"WhiteElo", "white_elo"},
-    {"BlackElo", "black_elo"},
-    {"Result", "result"},
-    {"WhiteRatingDiff", "white_rating_diff"},
-    {"BlackRatingDiff", "black_rating_diff"},
-    {"TimeControl", "time_control"},
-    {"Termination", "termination"},
-    {"ECO", "eco"},
-    {"Opening", "opening"},
-    {"w_move", "white_n_moves"},
-    {"b_move", "black_n_moves"},
-    {"player_move", "player_n_moves"},
-    {"move", "moves"}
+// kolom default (tanpa --columns / columns) = semua field sebelum kolom replay
+constexpr int DEFAULT_FIELD_COUNT = FIELD_MOVES_UCI;
+constexpr int REPLAY_FIELD_END = FIELD_CLOCKS;
+
+struct SchemaField {
+    std::string_view pgn_key;
+    std::string_view csv_key;
+    ArrowType arrow_type;  // tipe kolom untuk --format=arrow
 };
 
+using Schema = std::array<SchemaField, FIELD_COUNT>;
+constexpr Schema CSV_SCHEMA = {{
+    {"Event", "event", ArrowType::Dictionary},
+    {"Site", "link", ArrowType::Utf8},
+    {"Date", "date", ArrowType::Utf8},
+    {"White", "white", ArrowType::Utf8},
+    {"Black", "black", ArrowType::Utf8},
+    {"WhiteTitle", "white_titled", ArrowType::Dictionary},
+    {"BlackTitle", "black_titled", ArrowType::Dictionary},
+    {"WhiteElo", "white_elo", ArrowType::Int16},
+    {"BlackElo", "black_elo", ArrowType::Int16},
+    {"Result", "result", ArrowType::Dictionary},
+    {"WhiteRatingDiff", "white_rating_diff", ArrowType::Int16},
+    {"BlackRatingDiff", "black_rating_diff", ArrowType::Int16},
+    {"TimeControl", "time_control", ArrowType::Dictionary},
+    {"Termination", "termination", ArrowType::Dictionary},
+    {"ECO", "eco", ArrowType::Dictionary},
+    {"Opening", "opening", ArrowType::Dictionary},
+    {"w_move", "white_n_moves", ArrowType::Int16},
+    {"b_move", "black_n_moves", ArrowType::Int16},
+    {"player_move", "player_n_moves", ArrowType::Int16},
+    {"move", "moves", ArrowType::LargeUtf8},
+    {"uci_move", "moves_uci", ArrowType::LargeUtf8},
+    {"final_fen", "final_fen", ArrowType::Utf8},
+    {"material", "material", ArrowType::Utf8},
+    {"w_capture", "white_captures", ArrowType::Int16},
+    {"b_capture", "black_captures", ArrowType::Int16},
+    {"w_check", "white_checks", ArrowType::Int16},
+    {"b_check", "black_checks", ArrowType::Int16},
+    {"replay_error", "replay_error", ArrowType::Utf8},
+    {"clk", "clocks", ArrowType::LargeUtf8},
+    {"move_time", "move_times", ArrowType::LargeUtf8},
+    {"eval", "evals", ArrowType::LargeUtf8},
+    {"eval_swing", "max_eval_swing", ArrowType::Int16},
+    {"w_low_clock", "white_moves_under_10s", ArrowType::Int16},
+    {"b_low_clock", "black_moves_under_10s", ArrowType::Int16}
+}};
+
+// Tag PGN -> slot, dicek dari panjang key lalu huruf pertama.
+// Tag yang tidak ada di CSV_SCHEMA menghasilkan FIELD_UNKNOWN.
+constexpr int tag_field(std::string_view key) {
+    switch (key.size()) {
+    case 3:
+        return key == "ECO" ? FIELD_ECO : FIELD_UNKNOWN;
+    case 4:
+        if (key == "Site") return FIELD_SITE;
+        if (key == "Date") return FIELD_DATE;
+        return FIELD_UNKNOWN;
+    case 5:
+        if (key == "Event") return FIELD_EVENT;
+        if (key == "White") return FIELD_WHITE;
+        if (key == "Black") return FIELD_BLACK;
+        return FIELD_UNKNOWN;
+    case 6:
+        return key == "Result" ? FIELD_RESULT : FIELD_UNKNOWN;
+    case 7:
+        return key == "Opening" ? FIELD_OPENING : FIELD_UNKNOWN;
+    case 8:
+        if (key == "WhiteElo") return FIELD_WHITE_ELO;
+        if (key == "BlackElo") return FIELD_BLACK_ELO;
+        return FIELD_UNKNOWN;
+    case 10:
+        if (key == "WhiteTitle") return FIELD_WHITE_TITLE;
+        if (key == "BlackTitle") return FIELD_BLACK_TITLE;
+        return FIELD_UNKNOWN;
+    case 11:
+        if (key == "TimeControl") return FIELD_TIME_CONTROL;
+        if (key == "Termination") return FIELD_TERMINATION;
+        return FIELD_UNKNOWN;
+    case 15:
+        if (key == "WhiteRatingDiff") return FIELD_WHITE_RATING_DIFF;
+        if (key == "BlackRatingDiff") return FIELD_BLACK_RATING_DIFF;
+        return FIELD_UNKNOWN;
+    default:
+        return FIELD_UNKNOWN;
+    }
+}
+
+constexpr bool schema_matches_fields() {
+    for (int i = 0; i < FIELD_COUNT; ++i) {
+        int expected = i < FIELD_WHITE_N_MOVES ? i : FIELD_UNKNOWN;
+        if (tag_field(CSV_SCHEMA[i].pgn_key) != expected) return false;
+    }
+    return true;
+}
+static_assert(schema_matches_fields(), "CSV_SCHEMA harus sama urutannya dengan enum Field");
+
 
 void prevent_sleep() {
 #ifdef _WIN32
@@ -66,6 +225,7 @@ void prevent_sleep() {
 class Logger {
 private:
     std::ofstream file;
+    std::mutex mutex;  // writer thread juga menulis log
 
     std::string timestamp() {
         auto now = std::chrono::system_clock::now();
@@ -87,8 +247,20 @@ public:
     }
 
     void info(const std::string& msg, bool also_console = false) {
+        write("INFO", msg, also_console);
+    }
+
+    // satu baris JSON per snapshot, untuk dibandingkan antar run
+    void stats(const std::string& json) {
+        write("STATS", json, false);
+        file.flush();
+    }
+
+private:
+    void write(const char *level, const std::string& msg, bool also_console) {
+        std::lock_guard<std::mutex> lock(mutex);
         std::string full =
-            "[" + timestamp() + "] [INFO] " + msg;
+            "[" + timestamp() + "] [" + level + "] " + msg;
 
         file << full << "\n";
 
@@ -98,12 +270,84 @@ public:
     }
 };
 
-string log_progress(long scanned, long collected, long total, std::chrono::steady_clock::time_point start_time) {
+// Waktu kerja per stage pipeline, dijumlah dari semua thread. Thread mengukur
+// dengan steady_clock per blok kerja (bukan per baris) lalu menambah ke sini.
+enum Stage {
+    STAGE_READ,        // baca file .zst
+    STAGE_DECOMPRESS,  // ZSTD
+    STAGE_SPLIT,       // potong teks jadi batch per game
+    STAGE_SCAN,        // pecah baris + filter header
+    STAGE_PARSE,       // parse header + movetext game yang lolos
+    STAGE_WRITE,       // CSV / Arrow
+    STAGE_COUNT
+};
+static const char *STAGE_NAMES[STAGE_COUNT] = { "read", "decompress", "split", "scan", "parse", "write" };
+
+struct PipelineStats {
+    std::array<std::atomic<uint64_t>, STAGE_COUNT> stage_ns{};
+    std::atomic<uint64_t> compressed_bytes{0};
+    std::atomic<uint64_t> decompressed_bytes{0};
+    std::atomic<uint64_t> reader_wait_ns{0};  // reader menunggu worker (backpressure)
+
+    void add(Stage stage, uint64_t ns) {
+        stage_ns[stage].fetch_add(ns, std::memory_order_relaxed);
+    }
+};
+static PipelineStats pipeline_stats;
+
+// ns sejak start, lalu start dipindah ke sekarang
+uint64_t lap_ns(std::chrono::steady_clock::time_point &start) {
+    auto now = std::chrono::steady_clock::now();
+    uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - start).count();
+    start = now;
+    return ns;
+}
+
+string stats_json(const char *event, long scanned, long collected, std::chrono::steady_clock::time_point start_time,
+                  long scanned_before = 0) {
+    double elapsed_sec = std::chrono::duration<double>(steady_clock::now() - start_time).count();
+    double rate_sec = elapsed_sec > 0 ? elapsed_sec : 1e-9;
+    double compressed_mb = pipeline_stats.compressed_bytes / 1048576.0;
+    double decompressed_mb = pipeline_stats.decompressed_bytes / 1048576.0;
+
+    double total_ns = 0;
+    for (const auto &ns : pipeline_stats.stage_ns) total_ns += ns;
+
+    std::ostringstream oss;
+    oss << fixed << setprecision(3)
+        << "{\"event\":\"" << event << "\""
+        << ",\"elapsed_s\":" << setprecision(6) << elapsed_sec << setprecision(3)
+        << ",\"scanned\":" << scanned
+        << ",\"kept\":" << collected
+        << ",\"compressed_mb\":" << compressed_mb
+        << ",\"decompressed_mb\":" << decompressed_mb
+        << ",\"compressed_mb_s\":" << compressed_mb / rate_sec
+        << ",\"decompressed_mb_s\":" << decompressed_mb / rate_sec
+        << ",\"scanned_g_s\":" << (scanned - scanned_before) / rate_sec
+        << ",\"kept_g_s\":" << collected / rate_sec
+        << ",\"reader_wait_s\":" << pipeline_stats.reader_wait_ns / 1e9;
+
+    oss << ",\"stage_s\":{";
+    for (int i = 0; i < STAGE_COUNT; ++i) {
+        oss << (i ? "," : "") << "\"" << STAGE_NAMES[i] << "\":" << setprecision(6) << pipeline_stats.stage_ns[i] / 1e9;
+    }
+    oss << "},\"stage_pct\":{" << setprecision(1);
+    for (int i = 0; i < STAGE_COUNT; ++i) {
+        double pct = total_ns > 0 ? pipeline_stats.stage_ns[i] * 100.0 / total_ns : 0.0;
+        oss << (i ? "," : "") << "\"" << STAGE_NAMES[i] << "\":" << pct;
+    }
+    oss << "}}";
+    return oss.str();
+}
+
+// scanned_before: game yang sudah discan sebelum resume, tidak dihitung ke speed
+string log_progress(long scanned, long collected, long total, std::chrono::steady_clock::time_point start_time,
+                    long scanned_before = 0) {
 
     auto now = steady_clock::now();
-    double elapsed_sec = duration_cast<seconds>(now - start_time).count();
+    double elapsed_sec = std::chrono::duration<double>(now - start_time).count();
 
-    double speed = scanned > 0 ? scanned / elapsed_sec : 0.0;
+    double speed = scanned > scanned_before && elapsed_sec > 0 ? (scanned - scanned_before) / elapsed_sec : 0.0;
     double pct = (double)scanned / total * 100.0;
     double eta_sec = speed > 0 ? (total - scanned) / speed : 0.0;
 
@@ -118,316 +362,2769 @@ string log_progress(long scanned, long collected, long total, std::chrono::stead
     return oss.str();
 }
 
-struct OrderedDict {
-    std::unordered_map<std::string, std::string> data;
-    std::vector<std::string> order;
-
-    void insert(const std::string &key, const std::string &value) {
-        if (data.find(key) == data.end()) {
-            order.push_back(key);
-        }
-        data[key] = value;
-    }
+// Value hanya view ke teks batch (atau ke storage batch untuk nilai hasil
+// parsing). Slot kosong ditulis sebagai "" di CSV.
+struct GameRecord {
+    std::array<std::string_view, FIELD_COUNT> slots{};
 };
 
-OrderedDict parse_game_header(const string &raw_game) {
+GameRecord parse_game_header(std::string_view header) {
 
-    OrderedDict game;
-    std::stringstream ss(raw_game);
-    std::string header_line;
+    GameRecord game;
+    size_t line_start = 0;
+    size_t first_quote = std::string_view::npos;
+    size_t last_quote = std::string_view::npos;
 
-    while (std::getline(ss, header_line)) {
-        if (header_line.empty()) break; // header selesai
+    // quote pertama dan terakhir tiap baris dari scanner, '[' dan spasi
+    // dicari biasa (selalu di awal baris). Batas header sudah dari
+    // scan_header, baris kosong di tengahnya dilewati.
+    auto finish_line = [&](size_t line_end) {
+        std::string_view header_line = header.substr(line_start, line_end - line_start);
+        bool blank = header_line.empty() || header_line == "\r";
 
-        size_t start_key = header_line.find('[');
+        size_t start_key = blank ? std::string_view::npos : header_line.find('[');
         size_t end_key   = header_line.find(' ', start_key);
-        size_t start_val = header_line.find('"', end_key);
-        size_t end_val   = header_line.rfind('"');
+        size_t start_val = first_quote == std::string_view::npos ? first_quote : first_quote - line_start;
+        size_t end_val   = last_quote == std::string_view::npos ? last_quote : last_quote - line_start;
+        if (start_val != std::string_view::npos && end_key != std::string_view::npos && start_val < end_key) {
+            start_val = header_line.find('"', end_key);  // quote di dalam key
+        }
 
-        if (start_key != std::string::npos &&
-            end_key   != std::string::npos &&
-            start_val != std::string::npos &&
-            end_val   != std::string::npos) {
+        if (start_key != std::string_view::npos &&
+            end_key   != std::string_view::npos &&
+            start_val != std::string_view::npos &&
+            end_val   != std::string_view::npos) {
 
-            // assign key value
-            std::string key   = header_line.substr(start_key + 1, end_key - start_key - 1);
-            std::string value = header_line.substr(start_val + 1, end_val - start_val - 1);
-            game.insert(key, value);
+            // assign key value, tag di luar schema dilewati
+            std::string_view key = header_line.substr(start_key + 1, end_key - start_key - 1);
+            int field = tag_field(key);
+            if (field != FIELD_UNKNOWN) {
+                game.slots[field] = header_line.substr(start_val + 1, end_val - start_val - 1);
+            }
         }
-    }
+
+        line_start = line_end + 1;
+        first_quote = last_quote = std::string_view::npos;
+        return true;
+    };
+
+    static const pgn_scan::Class classes[] = { pgn_scan::NEWLINE, pgn_scan::QUOTE };
+    size_t stop = pgn_scan::for_each(header, 0, header.size(), classes, [&](size_t pos, pgn_scan::Class c) {
+        if (c == pgn_scan::NEWLINE) return finish_line(pos);
+        if (first_quote == std::string_view::npos) first_quote = pos;
+        last_quote = pos;
+        return true;
+    });
+    if (stop == header.size() && line_start < header.size()) finish_line(header.size());
 
     return game;
 }
 
-OrderedDict parse_game_moves(const OrderedDict &game_header, const string &raw_game) {
-    OrderedDict game = game_header;
-    std::string line;
-    std::string moves_str;
-    std::stringstream ss(raw_game);
-
-    while (std::getline(ss, line)) {
-        if (!line.empty() && line[0] == '[') continue;
-        moves_str += line + " ";
+static const int SWING_CLAMP_CP = 1000;    // eval di-clamp ke +-10 pion sebelum menghitung swing
+static const int LOW_CLOCK_CS = 1000;      // batas langkah di bawah 10 detik
+
+// Kolom anotasi dari hasil clean_moves. Array per ply dipisah spasi, ply
+// tanpa nilai ditulis "nan". Waktu per langkah = sisa sebelum langkah - sisa
+// sesudahnya + increment (langkah pertama tiap sisi dari base TimeControl,
+// tanpa increment). Ply dihitung dari putih.
+void annotate_game_moves(GameRecord &game, Annotations &annotations, StringArena &storage) {
+    const std::vector<int> &clocks = annotations.clocks;
+    const std::vector<int> &evals = annotations.evals;
+    std::string &text = annotations.text;
+    if (clocks.empty()) return;
+
+    auto append = [&](int value) {
+        if (!text.empty()) text += ' ';
+        if (value == NO_ANNOTATION) text += "nan";
+        else text += std::to_string(value);
+    };
+
+    // "180+2" -> base 18000 cs, increment 200 cs; "-" (correspondence) tidak diketahui
+    std::string_view time_control = game.slots[FIELD_TIME_CONTROL];
+    size_t plus = time_control.find('+');
+    int base = NO_ANNOTATION, increment = 0;
+    if (plus != std::string_view::npos && parse_int(time_control, 0, plus, base) &&
+        parse_int(time_control, plus + 1, time_control.size(), increment) && base >= 0 && increment >= 0 &&
+        base <= INT_MAX / 100 && increment <= INT_MAX / 100) {
+        base *= 100;
+        increment *= 100;
+    } else {
+        base = NO_ANNOTATION;
+        increment = 0;
     }
 
-    // cleaning moves
-    moves_str = std::regex_replace(moves_str, std::regex(R"(\{.*?\})"), "");
-    moves_str = std::regex_replace(moves_str, std::regex(R"(\d+\.\.\.)"), ",");
-    moves_str = std::regex_replace(moves_str, std::regex(R"(\d+\.)"), ".");
-    moves_str = std::regex_replace(moves_str, std::regex(R"(\s*(1-0|0-1|1/2-1/2)\s*$)"), "");
-    moves_str = std::regex_replace(moves_str, std::regex(R"([!?])"), "");
-    moves_str = std::regex_replace(moves_str, std::regex(R"(\s+)"), "");
-
-    // count moves
-    int w_count = moves_str.empty()
-        ? 0
-        : std::count(moves_str.begin(), moves_str.end(), '.');
+    bool has_clock = std::any_of(clocks.begin(), clocks.end(), [](int clock) { return clock != NO_ANNOTATION; });
+    text.clear();
+    for (int clock : clocks) append(clock);
+    if (has_clock) game.slots[FIELD_CLOCKS] = storage.store(text);
+
+    text.clear();
+    int before[2] = { base, base };
+    bool moved[2] = { false, false };
+    int low_clock[2] = { 0, 0 };
+    for (size_t ply = 0; ply < clocks.size(); ++ply) {
+        int side = ply % 2, clock = clocks[ply], spent = NO_ANNOTATION;
+        if (clock != NO_ANNOTATION) {
+            if (before[side] != NO_ANNOTATION) {
+                spent = (int)std::max<int64_t>(0, (int64_t)before[side] - clock + (moved[side] ? increment : 0));
+            }
+            before[side] = clock;
+            if (clock < LOW_CLOCK_CS) low_clock[side]++;
+        }
+        moved[side] = true;
+        append(spent);
+    }
+    if (has_clock) game.slots[FIELD_MOVE_TIMES] = storage.store(text);
+
+    // swing = selisih eval dua ply berurutan, setelah clamp (mate = +-10 pion)
+    text.clear();
+    int max_swing = -1;
+    for (size_t ply = 0; ply < evals.size(); ++ply) {
+        append(evals[ply]);
+        if (ply == 0 || evals[ply] == NO_ANNOTATION || evals[ply - 1] == NO_ANNOTATION) continue;
+        int now = std::clamp(evals[ply], -SWING_CLAMP_CP, SWING_CLAMP_CP);
+        int prev = std::clamp(evals[ply - 1], -SWING_CLAMP_CP, SWING_CLAMP_CP);
+        max_swing = std::max(max_swing, std::abs(now - prev));
+    }
+    bool has_eval = std::any_of(evals.begin(), evals.end(), [](int eval) { return eval != NO_ANNOTATION; });
+    if (has_eval) game.slots[FIELD_EVALS] = storage.store(text);
+    if (max_swing >= 0) game.slots[FIELD_MAX_EVAL_SWING] = storage.store(std::to_string(max_swing));
+    if (has_clock) {
+        game.slots[FIELD_WHITE_LOW_CLOCK_MOVES] = storage.store(std::to_string(low_clock[0]));
+        game.slots[FIELD_BLACK_LOW_CLOCK_MOVES] = storage.store(std::to_string(low_clock[1]));
+    }
+}
 
-    int b_count = moves_str.empty()
-        ? 0
-        : std::count(moves_str.begin(), moves_str.end(), ',');
+// Nilai baru (moves dan jumlah langkah) disimpan di arena milik batch,
+// record hanya menyimpan view-nya. annotate hanya untuk job dengan kolom anotasi.
+void parse_game_moves(GameRecord &game, std::string_view movetext,
+                      MoveText &move_text, StringArena &storage, bool annotate = false) {
+    clean_moves(movetext, move_text, annotate);
 
-    // cleaning moves
-    moves_str = std::regex_replace(moves_str, std::regex(R"(\,)"), " ");
-    moves_str = std::regex_replace(moves_str, std::regex(R"(\.)"), " ");
-    moves_str = std::regex_replace(moves_str, std::regex(R"(^\s+)"), "");
+    auto store = [&](std::string_view value) { return storage.store(value); };
 
     // assign key value
-    game.insert("move", moves_str);
-    game.insert("w_move", std::to_string(w_count));
-    game.insert("b_move", std::to_string(b_count));
-    game.insert("player_move", std::to_string(w_count + b_count));
+    game.slots[FIELD_MOVES] = store(move_text.moves);
+    game.slots[FIELD_WHITE_N_MOVES] = store(std::to_string(move_text.white_moves));
+    game.slots[FIELD_BLACK_N_MOVES] = store(std::to_string(move_text.black_moves));
+    game.slots[FIELD_PLAYER_N_MOVES] = store(std::to_string(move_text.white_moves + move_text.black_moves));
+    if (annotate) annotate_game_moves(game, move_text.annotations, storage);
+}
 
-    return game;
+static const size_t MAX_JOBS = 64;  // job per pass, satu bit per job di mask game
+static const int ELO_BUCKET = 200;  // lebar bucket rata-rata Elo untuk sampel per stratum
+
+// FIRST: ambil game pertama yang lolos sampai limit. Mode lain menyimpan
+// sampel seragam dari seluruh stream (limit = ukuran sampel, per stratum
+// untuk ELO / ECO / TIME_CONTROL) dan menulisnya setelah scan selesai.
+enum class SampleMode { FIRST, RESERVOIR, ELO, ECO, TIME_CONTROL };
+
+bool parse_sample_mode(std::string_view name, SampleMode &mode) {
+    if (name == "first") mode = SampleMode::FIRST;
+    else if (name == "reservoir") mode = SampleMode::RESERVOIR;
+    else if (name == "elo") mode = SampleMode::ELO;
+    else if (name == "eco") mode = SampleMode::ECO;
+    else if (name == "time_control") mode = SampleMode::TIME_CONTROL;
+    else return false;
+    return true;
+}
+
+const char *sample_mode_name(SampleMode mode) {
+    static const char *NAMES[] = { "first", "reservoir", "elo", "eco", "time_control" };
+    return NAMES[(int)mode];
 }
 
-bool filter_game(const OrderedDict &game_header, int min_elo = MIN_ELO) {
-    auto w_elo = game_header.data.find("WhiteElo");
-    auto b_elo = game_header.data.find("BlackElo");
-    auto t_con = game_header.data.find("TimeControl");
+// Satu output dari satu pass: filter, kolom, file, dan limit sendiri.
+// Tanpa --manifest, argumen command line menjadi satu job.
+struct Job {
+    std::string name;
+    FilterProgram filter;
+    std::vector<Field> columns;  // kolom CSV_SCHEMA yang ditulis, sesuai urutan
+    fs::path output;
+    std::string format = "csv";  // csv | arrow | tree | players | store | npy
+    size_t limit = games_to_read;
+    SampleMode sample = SampleMode::FIRST;
+    uint64_t seed = 1;
+    int tree_plies = TREE_PLIES;
+    size_t tree_memory_mb = TREE_MEMORY_MB;
+    size_t player_memory_mb = PLAYER_MEMORY_MB;
+    int npy_plies = NPY_PLIES;
+    size_t shard_rows = NPY_SHARD_ROWS;
+
+    bool sampled() const {
+        return sample != SampleMode::FIRST;
+    }
+
+    // opening tree dari semua game yang lolos filter, limit tidak dipakai
+    bool tree() const {
+        return format == "tree";
+    }
+
+    // satu row per pemain dari semua game yang lolos filter, limit tidak dipakai
+    bool players() const {
+        return format == "players";
+    }
+
+    // game store biner dari semua game yang lolos filter, limit tidak dipakai
+    bool store() const {
+        return format == "store";
+    }
+
+    // shard token / label .npy, lihat npy_writer.h
+    bool npy() const {
+        return format == "npy";
+    }
+
+    // kolom = slot awal record dengan urutan yang sama, bisa ditulis langsung
+    bool slot_order() const {
+        for (size_t i = 0; i < columns.size(); ++i) {
+            if (columns[i] != (Field)i) return false;
+        }
+        return true;
+    }
+
+    bool replay() const {
+        for (Field field : columns) {
+            if (field >= FIELD_MOVES_UCI && field < REPLAY_FIELD_END) return true;
+        }
+        return false;
+    }
 
-    // cek apakah data ada di dalam dictionary game
-    if (w_elo == game_header.data.end() || b_elo == game_header.data.end() || t_con == game_header.data.end()){
+    bool annotations() const {
+        for (Field field : columns) {
+            if (field >= REPLAY_FIELD_END) return true;
+        }
         return false;
     }
+};
 
-    try {
-        int white_elo = std::stoi(w_elo->second);
-        int black_elo = std::stoi(b_elo->second);
+std::vector<Job> JOBS;  // diisi di main dari --manifest atau argumen
 
-        // filter elo
-        if (white_elo < min_elo || black_elo < min_elo){
-            return false;
+// kolom output job --format tree, satu row per posisi
+static const std::array<std::string_view, 11> TREE_COLUMNS = {
+    "key", "parent", "ply", "moves_uci", "fen", "games", "white_wins", "draws", "black_wins", "white_score", "avg_elo"
+};
+
+// kolom output job --format players, satu row per pemain
+static const std::array<std::string_view, 18> PLAYER_COLUMNS = {
+    "player", "games", "white_games", "wins", "draws", "losses", "score", "first_rating", "last_rating",
+    "min_rating", "max_rating", "bullet", "blitz", "rapid", "classical", "correspondence", "favourite_ecos",
+    "rating_by_week"
+};
+
+void write_csv_header(const Job &job, CSVWriter &csv) {
+    if (job.tree()) {
+        csv.write_header(TREE_COLUMNS.data(), TREE_COLUMNS.size());
+        return;
+    }
+    if (job.players()) {
+        csv.write_header(PLAYER_COLUMNS.data(), PLAYER_COLUMNS.size());
+        return;
+    }
+    std::vector<std::string_view> names;
+    for (Field field : job.columns) names.push_back(CSV_SCHEMA[field].csv_key);
+    csv.write_header(names.data(), names.size());
+}
+
+// Salinan game yang masuk sampel: teks batch sudah dilepas saat sampel ditulis
+struct OwnedRecord {
+    std::string text;
+    std::array<uint32_t, FIELD_COUNT + 1> offsets{};
+    uint64_t order = 0;  // (index batch << 32) | urutan game di batch, untuk urutan output
+
+    void assign(const GameRecord &game, uint64_t order_key) {
+        text.clear();
+        for (int i = 0; i < FIELD_COUNT; ++i) {
+            offsets[i] = (uint32_t)text.size();
+            text.append(game.slots[i]);
         }
+        offsets[FIELD_COUNT] = (uint32_t)text.size();
+        order = order_key;
+    }
+
+    GameRecord view() const {
+        GameRecord game;
+        for (int i = 0; i < FIELD_COUNT; ++i) {
+            game.slots[i] = std::string_view(text).substr(offsets[i], offsets[i + 1] - offsets[i]);
+        }
+        return game;
+    }
+};
 
-        const std::string &time_con = t_con->second; 
-        size_t plus_sign = time_con.find('+');
-        int base_time = std::stoi(time_con.substr(0, plus_sign));
+// Papan dan buffer replay, dipakai ulang antar game seperti MoveText
+struct Replay {
+    chess::Board board;
+    std::string uci;
+    std::string fen;
+    std::string material;
+    std::string error;
+    int captures[2] = { 0, 0 };
+    int checks[2] = { 0, 0 };
+};
 
-        // filter time control
-        if (base_time < 180 || base_time > 300){
-            return false;
+// Replay token SAN hasil clean_moves (MoveText::san, bukan kolom moves yang
+// bisa menempelkan dua langkah) untuk kolom replay. Posisi awal dari tag FEN
+// jika ada. SAN ilegal / ambigu tidak menghentikan run: replay game itu
+// berhenti, kolom berisi keadaan sebelum langkah tsb dan replay_error alasannya.
+void replay_game_moves(GameRecord &game, std::string_view header, const MoveText &move_text,
+                       Replay &replay, StringArena &storage) {
+    chess::Board &board = replay.board;
+    board = chess::Board();
+    replay.uci.clear();
+    replay.material.clear();
+    replay.error.clear();
+    replay.captures[0] = replay.captures[1] = 0;
+    replay.checks[0] = replay.checks[1] = 0;
+
+    std::string_view variant = header_tag(header, "Variant");
+    std::string_view fen = header_tag(header, "FEN");
+    if (!variant.empty() && variant != "Standard" && variant != "From Position") {
+        replay.error = "unsupported variant " + std::string(variant);
+    } else if (!fen.empty() && !board.set_fen(fen)) {
+        replay.error = "invalid FEN";
+    }
+
+    std::string_view moves = move_text.san;
+    size_t pos = 0;
+    int ply = 0;
+    while (replay.error.empty() && pos < moves.size()) {
+        size_t end = std::min(moves.find(' ', pos), moves.size());
+        std::string_view san = moves.substr(pos, end - pos);
+        pos = end + 1;
+        if (san.empty() || san == "*" || san[0] == '$') continue;  // result "*" / NAG
+
+        chess::Move move;
+        chess::SanError error = board.parse_san(san, move);
+        if (error != chess::SanError::NONE) {
+            const char *reason = error == chess::SanError::AMBIGUOUS ? "ambiguous" :
+                                 error == chess::SanError::SYNTAX ? "invalid" : "illegal";
+            replay.error = std::string(reason) + " SAN at ply " + std::to_string(ply + 1) + ": " + std::string(san);
+            break;
         }
 
-        return true;
+        chess::Color mover = board.side;
+        if (board.is_capture(move)) replay.captures[mover]++;
+        if (!replay.uci.empty()) replay.uci += ' ';
+        chess::Board::append_uci(move, replay.uci);
+        board.make(move);
+        if (board.in_check()) replay.checks[mover]++;
 
-    } catch (...) {
-        return false;
+        if (++ply % MATERIAL_PLIES == 0) {
+            if (!replay.material.empty()) replay.material += ' ';
+            replay.material += std::to_string(board.material());
+        }
+    }
+
+    replay.fen.clear();
+    board.append_fen(replay.fen);
+
+    auto store = [&](std::string_view value) { return storage.store(value); };
+
+    game.slots[FIELD_MOVES_UCI] = store(replay.uci);
+    game.slots[FIELD_FINAL_FEN] = store(replay.fen);
+    game.slots[FIELD_MATERIAL] = store(replay.material);
+    game.slots[FIELD_WHITE_CAPTURES] = store(std::to_string(replay.captures[chess::WHITE]));
+    game.slots[FIELD_BLACK_CAPTURES] = store(std::to_string(replay.captures[chess::BLACK]));
+    game.slots[FIELD_WHITE_CHECKS] = store(std::to_string(replay.checks[chess::WHITE]));
+    game.slots[FIELD_BLACK_CHECKS] = store(std::to_string(replay.checks[chess::BLACK]));
+    if (!replay.error.empty()) game.slots[FIELD_REPLAY_ERROR] = store(replay.error);
+}
+
+// replay_error karena langkah yang memang ada di game (SAN ilegal / ambigu):
+// langkah sebelumnya tetap benar, game terpotong. Error lain (token bukan SAN,
+// variant, FEN) berarti movetext tidak terbaca, bukan terpotong.
+bool replay_truncated(std::string_view error) {
+    return error.substr(0, 8) == "illegal " || error.substr(0, 10) == "ambiguous ";
+}
+
+// Sampel satu job di satu worker: satu reservoir per stratum
+struct JobSampler {
+    SampleMode mode = SampleMode::RESERVOIR;
+    size_t size = 0;
+    uint64_t seed = 0;  // sudah dicampur dengan index job, sama di semua worker
+    std::map<std::string, Reservoir<OwnedRecord>, std::less<>> strata;
+
+    static std::string stratum(std::string_view header, SampleMode mode) {
+        switch (mode) {
+        case SampleMode::ELO: {
+            std::string_view white = header_tag(header, "WhiteElo"), black = header_tag(header, "BlackElo");
+            int white_elo, black_elo;
+            if (!parse_int(white, 0, white.size(), white_elo) || !parse_int(black, 0, black.size(), black_elo)) {
+                return "unknown";
+            }
+            int low = (white_elo + black_elo) / 2 / ELO_BUCKET * ELO_BUCKET;
+            return std::to_string(low) + "-" + std::to_string(low + ELO_BUCKET - 1);
+        }
+        case SampleMode::ECO:
+            return std::string(header_tag(header, "ECO"));
+        case SampleMode::TIME_CONTROL:
+            return std::string(header_tag(header, "TimeControl"));
+        default:
+            return "";
+        }
+    }
+
+    // offset: offset decompressed awal game di dump, identitas game yang
+    // tidak bergantung pada pembagian batch / worker
+    OwnedRecord *offer(std::string_view header, uint64_t offset) {
+        std::string key = stratum(header, mode);
+        auto it = strata.find(key);
+        if (it == strata.end()) it = strata.emplace(key, Reservoir<OwnedRecord>(size)).first;
+        return it->second.offer(mix_seed(seed ^ offset));
     }
 };
 
-OrderedDict normalize_to_schema(const OrderedDict &raw_game, const Schema &schema) {
-    OrderedDict out;
+std::vector<ArrowColumn> arrow_schema(const Job &job) {
+    std::vector<ArrowColumn> columns;
+    for (Field field : job.columns) {
+        columns.push_back({ CSV_SCHEMA[field].csv_key, CSV_SCHEMA[field].arrow_type });
+    }
+    return columns;
+}
 
-    for (const auto &[pgn_key, csv_key] : schema) {
+// Posisi di file .zst tempat decoding bisa dimulai ulang: awal frame zstd
+// terakhir sebelum batch, dan offset decompressed awal batch itu sendiri
+struct StreamPosition {
+    uint64_t compressed_offset = 0;  // awal frame zstd di file .zst
+    uint64_t frame_offset = 0;       // offset decompressed awal frame tsb
+    uint64_t stream_offset = 0;      // offset decompressed awal batch
+};
 
-        auto raw_key_value = raw_game.data.find(pgn_key);
+// Satu batch berisi beberapa game utuh, dipotong di baris "[Event ".
+// ZSTD menulis langsung ke buffer ini, jadi teks game tidak pernah disalin
+// kecuali game terakhir yang terpotong di ujung batch. Batch dari satu
+// range frame (decompress paralel) berbagi buffer yang sama.
+struct GameBatch {
+    size_t index = 0;
+    StreamPosition position;
+    std::shared_ptr<char[]> buffer;
+    char *data = nullptr;
+    size_t size = 0;
+    size_t capacity = 0;
+
+    explicit GameBatch(size_t capacity = 0)
+        : buffer(capacity ? new char[capacity] : nullptr), data(buffer.get()), capacity(capacity) {}
+
+    // buffer kosong milik BufferPool
+    GameBatch(std::shared_ptr<char[]> pooled, size_t capacity)
+        : buffer(std::move(pooled)), data(buffer.get()), capacity(capacity) {}
+
+    // view ke bagian buffer milik batch lain, tanpa salinan
+    GameBatch(const std::shared_ptr<char[]> &shared, std::string_view text)
+        : buffer(shared), data(const_cast<char *>(text.data())), size(text.size()), capacity(text.size()) {}
+
+    std::string_view text() const {
+        return std::string_view(data, size);
+    }
 
-        if (raw_key_value != raw_game.data.end()) {
-            out.insert(csv_key, raw_key_value->second);
-        } else {
-            out.insert(csv_key, "");  // kosong jika tidak ada
+    void grow(size_t new_capacity) {
+        std::shared_ptr<char[]> bigger(new char[new_capacity]);
+        memcpy(bigger.get(), data, size);
+        buffer = std::move(bigger);
+        data = buffer.get();
+        capacity = new_capacity;
+    }
+};
+
+// Buffer teks batch streaming dipakai ulang: buffer baru ~8 MB tiap batch
+// berarti mmap / munmap dan page fault ulang di setiap batch. Buffer kembali
+// ke pool saat batch terakhir yang merujuknya dilepas (setelah ditulis).
+class BufferPool : public std::enable_shared_from_this<BufferPool> {
+public:
+    explicit BufferPool(size_t capacity) : capacity(capacity) {}
+
+    ~BufferPool() {
+        for (char *buffer : free) delete[] buffer;
+    }
+
+    GameBatch batch() {
+        char *buffer = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!free.empty()) {
+                buffer = free.back();
+                free.pop_back();
+            }
+        }
+        if (!buffer) buffer = new char[capacity];
+
+        std::shared_ptr<BufferPool> self = shared_from_this();
+        return GameBatch(std::shared_ptr<char[]>(buffer, [self](char *used) { self->give_back(used); }), capacity);
+    }
+
+private:
+    size_t capacity;
+    std::mutex mutex;
+    std::vector<char *> free;
+
+    void give_back(char *buffer) {
+        std::lock_guard<std::mutex> lock(mutex);
+        free.push_back(buffer);
+    }
+};
+
+struct BatchResult {
+    size_t index = 0;
+    size_t scanned = 0;
+    unsigned owner = 0;                 // worker yang free list-nya menerima hasil ini kembali
+    GameBatch batch;                    // pemilik teks yang dirujuk oleh games
+    StringArena storage;                // nilai hasil parsing (moves, jumlah langkah)
+    std::vector<GameRecord> games;
+    std::vector<size_t> game_pos;       // urutan game di batch untuk tiap game yang lolos
+    std::vector<uint64_t> job_mask;     // job yang menerima tiap game yang lolos
+};
+
+// Hasil batch dipakai ulang beserta arena dan kapasitas vector-nya. Tiap
+// worker punya free list sendiri, writer mengembalikan hasil ke worker
+// asalnya setelah ditulis; teks batch dilepas saat itu juga. Worker hanya
+// memproses satu batch sekaligus, kelebihan di atas FREE_RESULTS dibuang
+// supaya hasil tidak menumpuk di free list saat writer tertinggal.
+class ResultPool {
+public:
+    explicit ResultPool(unsigned workers) {
+        for (unsigned w = 0; w < workers; ++w) lists.push_back(std::make_unique<FreeList>());
+    }
+
+    BatchResult acquire(unsigned worker) {
+        FreeList &list = *lists[worker];
+        BatchResult result;
+        {
+            std::lock_guard<std::mutex> lock(list.mutex);
+            if (!list.items.empty()) {
+                result = std::move(list.items.back());
+                list.items.pop_back();
+            }
         }
+        result.owner = worker;
+        return result;
+    }
+
+    void release(BatchResult &&result) {
+        result.batch = GameBatch();
+        FreeList &list = *lists[result.owner];
+        std::lock_guard<std::mutex> lock(list.mutex);
+        if (list.items.size() < FREE_RESULTS) list.items.push_back(std::move(result));
+    }
+
+private:
+    static const size_t FREE_RESULTS = 2;
+
+    struct FreeList {
+        std::mutex mutex;
+        std::vector<BatchResult> items;
+    };
+    std::vector<std::unique_ptr<FreeList>> lists;
+};
+
+// Posisi setelah tiap ply di awal game, untuk opening tree
+struct TreePosition {
+    uint64_t key = 0;
+    uint64_t parent = 0;
+    uint16_t move = 0;
+};
+
+// Kelas waktu ala Lichess dari perkiraan durasi base + 40 * increment detik,
+// "-" = correspondence. -1 jika TimeControl tidak dikenal.
+int player_time_class(std::string_view time_control) {
+    if (time_control == "-") return TC_CORRESPONDENCE;
+    size_t plus = time_control.find('+');
+    int base, increment;
+    if (plus == std::string_view::npos || !parse_int(time_control, 0, plus, base) ||
+        !parse_int(time_control, plus + 1, time_control.size(), increment) || base < 0 || increment < 0) {
+        return -1;
     }
+    int64_t estimate = (int64_t)base + 40 * (int64_t)increment;
+    if (estimate < 180) return TC_BULLET;
+    if (estimate < 480) return TC_BLITZ;
+    if (estimate < 1500) return TC_RAPID;
+    return TC_CLASSICAL;
+}
 
-    return out;
+// "2025.12.17" -> minggu ke-2 (0-4) di bulan itu, -1 jika hari tidak diketahui
+int player_week(std::string_view date) {
+    int day;
+    if (date.size() != 10 || !parse_int(date, 8, 10, day) || day < 1 || day > 31) return -1;
+    return std::min((day - 1) / 7, PLAYER_WEEKS - 1);
 }
 
-struct CSVWriter {
-    std::ofstream fout;
-    bool header_written = false;
+// "B20" -> 120, -1 untuk "?" atau kode lain
+int player_eco(std::string_view eco) {
+    if (eco.size() != 3 || eco[0] < 'A' || eco[0] > 'E' || !std::isdigit((unsigned char)eco[1]) ||
+        !std::isdigit((unsigned char)eco[2])) {
+        return -1;
+    }
+    return (eco[0] - 'A') * 100 + (eco[1] - '0') * 10 + (eco[2] - '0');
+}
+
+// Filter, sampler dan opening tree semua job untuk satu worker. Job yang
+// sudah mencapai limit (bit di finished) tidak dicek lagi.
+struct JobFilters {
+    std::vector<FilterState> states;
+    const std::atomic<uint64_t> *finished = nullptr;
+    uint64_t all = 0;
+    uint64_t alive = 0;  // job yang masih mungkin menerima game sekarang
+
+    // job dengan sampel: game yang lolos filter ditawarkan ke reservoir,
+    // slot berisi tempat salinan game yang terpilih sampai game selesai di-parse
+    uint64_t sampled = 0;
+    uint64_t replay = 0;  // job dengan kolom replay
+    uint64_t annotations = 0;  // job dengan kolom [%clk] / [%eval]
+    std::vector<JobSampler> samplers;
+    std::vector<OwnedRecord *> slots;
+
+    // job opening tree: satu tabel per worker, setengah budget job dibagi rata
+    // antar worker (setengah lagi untuk tabel gabungan di akhir)
+    uint64_t trees = 0;
+    std::vector<std::unique_ptr<OpeningTree>> opening_trees;
+    std::vector<TreePosition> positions;
+
+    // job players: sama seperti opening tree, satu shard per worker
+    uint64_t players = 0;
+    std::vector<std::unique_ptr<PlayerTable>> player_tables;
+
+    JobFilters(const std::vector<Job> &jobs, const std::atomic<uint64_t> &finished, unsigned workers = 1)
+        : finished(&finished), samplers(jobs.size()), slots(jobs.size(), nullptr), opening_trees(jobs.size()),
+          player_tables(jobs.size()) {
+        for (size_t j = 0; j < jobs.size(); ++j) {
+            states.emplace_back(jobs[j].filter);
+            if (jobs[j].replay()) replay |= uint64_t(1) << j;
+            if (jobs[j].annotations()) annotations |= uint64_t(1) << j;
+            if (jobs[j].tree()) {
+                trees |= uint64_t(1) << j;
+                size_t memory = (jobs[j].tree_memory_mb << 20) / 2 / workers;
+                opening_trees[j] = std::make_unique<OpeningTree>(memory, jobs[j].tree_plies);
+            }
+            if (jobs[j].players()) {
+                players |= uint64_t(1) << j;
+                size_t memory = (jobs[j].player_memory_mb << 20) / 2 / workers;
+                player_tables[j] = std::make_unique<PlayerTable>(memory);
+            }
+            if (!jobs[j].sampled()) continue;
+            sampled |= uint64_t(1) << j;
+            samplers[j].mode = jobs[j].sample;
+            samplers[j].size = jobs[j].limit;
+            samplers[j].seed = mix_seed(jobs[j].seed ^ (j << 32));
+        }
+        all = jobs.size() == MAX_JOBS ? ~uint64_t(0) : (uint64_t(1) << jobs.size()) - 1;
+    }
+
+    // job sampel yang melewati game ini dihapus dari mask
+    uint64_t offer_samples(uint64_t mask, std::string_view header, uint64_t offset) {
+        for (size_t j = 0; j < samplers.size(); ++j) {
+            if (!((mask & sampled) >> j & 1)) continue;
+            slots[j] = samplers[j].offer(header, offset);
+            if (!slots[j]) mask &= ~(uint64_t(1) << j);
+        }
+        return mask;
+    }
 
-    CSVWriter(const fs::path &filename) {
-        fout.open(filename);
-        if (!fout) {
-            throw std::runtime_error("Cannot open CSV file");
+    // salin game yang sudah di-parse ke slot reservoir
+    void store_samples(uint64_t mask, const GameRecord &game, uint64_t order) {
+        for (size_t j = 0; j < samplers.size(); ++j) {
+            if ((mask & sampled) >> j & 1) slots[j]->assign(game, order);
         }
     }
 
-    void write_game(const OrderedDict &game) {
-        // tulis header sekali
-        if (!header_written) {
-            for (size_t i = 0; i < game.order.size(); ++i) {
-                fout << game.order[i];
-                if (i + 1 < game.order.size()) fout << ",";
+    // job yang ditulis setelah scan selesai, bukan oleh writer per batch
+    uint64_t deferred() const {
+        return sampled | trees | players;
+    }
+
+    // Satu game masuk ke tabel pemain putih dan hitam. Rating sesudah game =
+    // Elo + RatingDiff (Lichess), atau Elo saja jika diff tidak ada.
+    void add_to_players(uint64_t mask, const GameRecord &game, uint64_t order) {
+        std::string_view result = game.slots[FIELD_RESULT];
+        int white_score = -1;
+        if (result == "1-0") white_score = 2;
+        else if (result == "0-1") white_score = 0;
+        else if (result == "1/2-1/2") white_score = 1;
+
+        PlayerGame sides[2];
+        for (int side = 0; side < 2; ++side) {
+            PlayerGame &player = sides[side];
+            bool white = side == 0;
+            player.name = game.slots[white ? FIELD_WHITE : FIELD_BLACK];
+            player.white = white;
+            player.order = order;
+            player.score = white_score < 0 ? -1 : white ? white_score : 2 - white_score;
+            player.time_class = player_time_class(game.slots[FIELD_TIME_CONTROL]);
+            player.week = player_week(game.slots[FIELD_DATE]);
+            player.eco = player_eco(game.slots[FIELD_ECO]);
+
+            std::string_view elo = game.slots[white ? FIELD_WHITE_ELO : FIELD_BLACK_ELO];
+            std::string_view diff = game.slots[white ? FIELD_WHITE_RATING_DIFF : FIELD_BLACK_RATING_DIFF];
+            int rating, change;
+            if (!parse_int(elo, 0, elo.size(), rating)) continue;
+            player.rating = rating;
+            player.rating_after = parse_int(diff, 0, diff.size(), change) ? rating + change : rating;
+        }
+
+        for (size_t j = 0; j < player_tables.size(); ++j) {
+            if (!((mask & players) >> j & 1)) continue;
+            for (const PlayerGame &player : sides) {
+                if (!player.name.empty() && player.name != "?") player_tables[j]->add(player);
             }
-            fout << "\n";
-            header_written = true;
+        }
+    }
+
+    // Replay ply awal game (token MoveText::san) sekali untuk semua job
+    // opening tree. Game tanpa hasil akhir ("*") atau yang tidak mulai dari
+    // posisi awal dilewati; replay berhenti di SAN yang tidak valid.
+    void add_to_trees(uint64_t mask, const GameRecord &game, std::string_view header, const MoveText &move_text,
+                      chess::Board &board) {
+        std::string_view result = game.slots[FIELD_RESULT];
+        GameResult outcome;
+        if (result == "1-0") outcome = GameResult::WHITE;
+        else if (result == "0-1") outcome = GameResult::BLACK;
+        else if (result == "1/2-1/2") outcome = GameResult::DRAW;
+        else return;
+
+        std::string_view variant = header_tag(header, "Variant");
+        if (!header_tag(header, "FEN").empty() || (!variant.empty() && variant != "Standard")) return;
+
+        std::string_view white = game.slots[FIELD_WHITE_ELO], black = game.slots[FIELD_BLACK_ELO];
+        int white_elo, black_elo, elo_sum = 0;
+        if (parse_int(white, 0, white.size(), white_elo) && parse_int(black, 0, black.size(), black_elo)) {
+            elo_sum = white_elo + black_elo;
+        }
+
+        int max_ply = 0;
+        for (size_t j = 0; j < opening_trees.size(); ++j) {
+            if ((mask & trees) >> j & 1) max_ply = std::max(max_ply, opening_trees[j]->max_ply);
         }
 
-        // tulis row
-        for (size_t i = 0; i < game.order.size(); ++i) {
-            const std::string &key = game.order[i];
-            std::string value = game.data.at(key);
+        board = chess::Board();
+        positions.clear();
+        positions.push_back({ board.hash(), 0, 0 });
+        std::string_view moves = move_text.san;
+        size_t pos = 0;
+        while ((int)positions.size() <= max_ply && pos < moves.size()) {
+            size_t end = std::min(moves.find(' ', pos), moves.size());
+            std::string_view san = moves.substr(pos, end - pos);
+            pos = end + 1;
+            if (san.empty() || san == "*" || san[0] == '$') continue;
+
+            chess::Move move;
+            if (board.parse_san(san, move) != chess::SanError::NONE) break;
+            board.make(move);
+            positions.push_back({ board.hash(), positions.back().key, move.pack() });
+        }
 
-            // escape double quote
-            size_t pos = 0;
-            while ((pos = value.find('"', pos)) != std::string::npos) {
-                value.insert(pos, "\"");
-                pos += 2;
+        for (size_t j = 0; j < opening_trees.size(); ++j) {
+            if (!((mask & trees) >> j & 1)) continue;
+            OpeningTree &tree = *opening_trees[j];
+            for (size_t ply = 0; ply < positions.size() && (int)ply <= tree.max_ply; ++ply) {
+                // posisi yang berulang di game yang sama dihitung sekali
+                bool repeated = false;
+                for (size_t k = 0; k < ply && !repeated; ++k) repeated = positions[k].key == positions[ply].key;
+                if (repeated) continue;
+                const TreePosition &position = positions[ply];
+                tree.add(position.key, position.parent, position.move, (int)ply, outcome, elo_sum);
             }
+        }
+    }
+
+    void reset() {
+        alive = all & ~finished->load(std::memory_order_relaxed);
+        for (size_t j = 0; j < states.size(); ++j) {
+            if ((alive >> j) & 1) states[j].reset();
+        }
+    }
+
+    // return false jika semua job menolak game ini
+    bool header_line(std::string_view line) {
+        for (size_t j = 0; j < states.size(); ++j) {
+            if (((alive >> j) & 1) && !filter_header_line(line, states[j])) alive &= ~(uint64_t(1) << j);
+        }
+        return alive != 0;
+    }
 
-            fout << "\"" << value << "\"";
-            if (i + 1 < game.order.size()) fout << ",";
+    // di akhir header: mask job yang menerima game
+    uint64_t finish() {
+        for (size_t j = 0; j < states.size(); ++j) {
+            if (((alive >> j) & 1) && !filter_game(states[j])) alive &= ~(uint64_t(1) << j);
         }
-        fout << "\n";
+        return alive;
     }
 };
 
-void flush_batch_to_csv(std::vector<OrderedDict> &batch, CSVWriter &csv) {
-    for (const auto &game : batch) {
-        csv.write_game(game);
+// Parse dan filter semua game di satu batch. Aman dipanggil paralel.
+// Batch dipindah ke result karena game yang lolos masih merujuk teksnya.
+void process_batch(GameBatch &&batch, BatchResult &result, MoveText &move_text, Replay &replay, JobFilters &filters) {
+    result.index = batch.index;
+    result.scanned = 0;
+    result.storage.reset();
+    result.games.clear();
+    result.game_pos.clear();
+    result.job_mask.clear();
+
+    uint64_t job_mask = 0;
+    size_t game_start = 0;
+
+    std::string_view text = batch.text();
+    uint64_t batch_offset = batch.position.stream_offset;
+    auto batch_start = std::chrono::steady_clock::now();
+    uint64_t parse_ns = 0;
+
+    // akhir header: filter semua job, lalu reservoir job sampel
+    auto accept_game = [&](std::string_view header) {
+        job_mask = filters.finish();
+        if (filters.sampled & job_mask) job_mask = filters.offer_samples(job_mask, header, batch_offset + game_start);
+        return job_mask != 0;
+    };
+
+    // hanya game yang lolos filter yang di-parse
+    auto parse_game = [&](const GameView &view) {
+        auto parse_start = std::chrono::steady_clock::now();
+        uint64_t order = (uint64_t)result.index << 32 | result.scanned;
+        GameRecord game = parse_game_header(view.header);
+        // job players hanya butuh header: movetext dilewati jika tidak ada job lain
+        if (job_mask & ~filters.players) {
+            parse_game_moves(game, view.movetext, move_text, result.storage, job_mask & filters.annotations);
+        }
+        if (job_mask & filters.replay) replay_game_moves(game, view.header, move_text, replay, result.storage);
+        if (job_mask & filters.trees) filters.add_to_trees(job_mask, game, view.header, move_text, replay.board);
+        if (job_mask & filters.players) filters.add_to_players(job_mask, game, order);
+        parse_ns += lap_ns(parse_start);
+
+        // job sampel menyimpan salinannya sendiri, job tree / players sudah
+        // diagregasi, sisanya ditulis writer
+        if (job_mask & filters.sampled) filters.store_samples(job_mask, game, order);
+        if (job_mask & ~filters.deferred()) {
+            result.games.push_back(game);
+            result.game_pos.push_back(result.scanned);
+            result.job_mask.push_back(job_mask & ~filters.deferred());
+        }
+    };
+
+    // batas game dan header memakai aturan yang sama dengan PgnStreamReader
+    // (find_game_start / scan_header): baris kosong di tengah header tidak
+    // memotong header. Tag filter dicek per baris header dan berhenti di tag
+    // pertama yang menolak. Batas baris tetap lewat find / memchr: di loop ini
+    // memchr sudah sebatas bandwidth memori dan bitmask newline pgn_scan
+    // terukur sedikit lebih lambat (baris header pendek, movetext hampir tanpa newline)
+    size_t next_game = find_game_start(text, 0);
+    while (next_game != std::string_view::npos) {
+        game_start = next_game;
+        next_game = find_game_start(text, game_start + 1);
+        size_t game_end = next_game == std::string_view::npos ? text.size() : next_game;
+        std::string_view raw_game = text.substr(game_start, game_end - game_start);
+
+        filters.reset();
+        size_t header_end, movetext_start;
+        bool keep = scan_header(raw_game, header_end, movetext_start,
+                                [&](std::string_view line) { return filters.header_line(line); });
+        std::string_view header = raw_game.substr(0, header_end);
+        if (keep && accept_game(header)) parse_game(GameView{ header, raw_game.substr(movetext_start), raw_game });
+
+        result.scanned++;
     }
-    batch.clear();  // kosongkan batch
+
+    uint64_t batch_ns = lap_ns(batch_start);
+    pipeline_stats.add(STAGE_PARSE, parse_ns);
+    pipeline_stats.add(STAGE_SCAN, batch_ns - std::min(batch_ns, parse_ns));
+
+    result.batch = std::move(batch);
 }
 
+// Queue thread-safe dengan kapasitas terbatas, close() untuk mengakhiri
+template <typename T>
+class BlockingQueue {
+private:
+    std::mutex mutex;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+    std::deque<T> items;
+    size_t capacity;
+    bool closed = false;
 
-int main() {
-    prevent_sleep();
+public:
+    explicit BlockingQueue(size_t capacity) : capacity(capacity) {}
+
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        not_full.wait(lock, [&] { return closed || items.size() < capacity; });
+        if (closed) return false;
+        items.push_back(std::move(item));
+        not_empty.notify_one();
+        return true;
+    }
 
-    Logger logger("logs/parser.log");
-    logger.info("======================================");
-    logger.info("Starting PGN parsing...", true);
-    auto start_time = std::chrono::steady_clock::now();
-    
-    const fs::path file_path = SOURCE_PATH;
-    CSVWriter csv_target(OUTPUT_PATH);
+    bool pop(T &item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        not_empty.wait(lock, [&] { return closed || !items.empty(); });
+        if (items.empty()) return false;
+        item = std::move(items.front());
+        items.pop_front();
+        not_full.notify_one();
+        return true;
+    }
 
-    // Baca file .zst secara streaming
-    ifstream fin(file_path, ios::binary);
-    if (!fin) {
-        cerr << "[ERROR] Cannot open file: " << file_path << endl;
-        return 1;
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        not_empty.notify_all();
+        not_full.notify_all();
     }
+};
 
-    // Bisa dekompres chunk per chunk
-    ZSTD_DStream* dstream = ZSTD_createDStream();
-    ZSTD_initDStream(dstream);
-    if (!dstream) {
-        cerr << "[ERROR] Cannot create ZSTD context\n";
-        return 1;
+// Menulis hasil batch ke CSV sesuai urutan input, jadi output sama
+// persis dengan run single-thread
+// Disimpan tiap CHECKPOINT_GAMES game supaya run yang terhenti bisa
+// dilanjutkan dengan --resume tanpa row dobel maupun hilang
+// FNV-1a dari definisi semua job, stabil antar build (tidak seperti std::hash)
+uint64_t jobs_hash(const std::vector<Job> &jobs) {
+    std::string text;
+    for (const auto &job : jobs) {
+        text += job.filter.source + "\n" + job.output.string() + "\n" + job.format + "\n";
+        for (Field field : job.columns) text += std::to_string(field) + ",";
+        text += "\n";
     }
 
-    const size_t IN_BUF_SIZE = ZSTD_DStreamInSize();
-    const size_t OUT_BUF_SIZE = ZSTD_DStreamOutSize();
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
 
-    vector<char> inBuf(IN_BUF_SIZE);
-    vector<char> outBuf(OUT_BUF_SIZE);
+// progres satu job saat checkpoint
+struct JobProgress {
+    uint64_t collected = 0;
+    uintmax_t csv_bytes = 0;
+};
 
-    vector<OrderedDict> all_games;  // menyimpan seluruh game
-    string current_game;
+struct Checkpoint {
+    uintmax_t source_size = 0;
+    StreamPosition position;
+    uint64_t scanned = 0;
+    uint64_t collected = 0;      // game unik yang ditulis ke minimal satu job
+    uintmax_t csv_bytes = 0;     // panjang CSV job pertama
+    uint64_t jobs_hash = 0;      // 0: checkpoint lama tanpa info job
+    std::vector<JobProgress> jobs;
+
+    void save(const fs::path &path) const {
+        // tulis ke file sementara dulu supaya checkpoint lama tidak rusak
+        fs::path tmp_path = path;
+        tmp_path += ".tmp";
+        {
+            std::ofstream out(tmp_path, std::ios::trunc);
+            out << "source_size " << source_size << "\n"
+                << "compressed_offset " << position.compressed_offset << "\n"
+                << "frame_offset " << position.frame_offset << "\n"
+                << "stream_offset " << position.stream_offset << "\n"
+                << "scanned " << scanned << "\n"
+                << "collected " << collected << "\n"
+                << "csv_bytes " << csv_bytes << "\n"
+                << "jobs_hash " << jobs_hash << "\n";
+            for (size_t i = 0; i < jobs.size(); ++i) {
+                out << "job_collected_" << i << " " << jobs[i].collected << "\n"
+                    << "job_csv_bytes_" << i << " " << jobs[i].csv_bytes << "\n";
+            }
+            if (!out) {
+                throw std::runtime_error("Cannot write checkpoint file");
+            }
+        }
+        fs::rename(tmp_path, path);
+    }
 
-    size_t scanned_games = 0;
-    size_t collected_games = 0;
-    
-    bool game_finished = false;
+    bool load(const fs::path &path) {
+        std::ifstream in(path);
+        if (!in) return false;
+
+        std::string key;
+        uint64_t value;
+        int found = 0;
+        while (in >> key >> value) {
+            found++;
+            if (key == "source_size") source_size = value;
+            else if (key == "compressed_offset") position.compressed_offset = value;
+            else if (key == "frame_offset") position.frame_offset = value;
+            else if (key == "stream_offset") position.stream_offset = value;
+            else if (key == "scanned") scanned = value;
+            else if (key == "collected") collected = value;
+            else if (key == "csv_bytes") csv_bytes = value;
+            else if (key == "jobs_hash") jobs_hash = value, found--;  // opsional
+            else {
+                load_job(key, value);  // job_* opsional, key lain diabaikan
+                found--;
+            }
+        }
 
-    while (collected_games < games_to_read && fin) {
-        fin.read(inBuf.data(), inBuf.size());
-        size_t bytes_read = fin.gcount();
-        if (bytes_read == 0) break;
+        // checkpoint lama: satu job
+        if (jobs.empty()) jobs.push_back({ collected, csv_bytes });
+        return found == 7 && position.frame_offset <= position.stream_offset;
+    }
 
-        ZSTD_inBuffer input{ inBuf.data(), bytes_read, 0 };
-
-        while (input.pos < input.size && collected_games < games_to_read) {
-
-            ZSTD_outBuffer output{ outBuf.data(), outBuf.size(), 0 };
-            size_t ret = ZSTD_decompressStream(dstream, &output, &input);
-            
-            if (ZSTD_isError(ret)) {
-                cerr << "[ERROR] ZSTD decompress error: "
-                     << ZSTD_getErrorName(ret) << endl;
-                return 1;
-            }
-
-            string chunk(outBuf.data(), output.pos);
-            stringstream ss(chunk);
-            string line;
-            
-            while (getline(ss, line)) {
-                if (line.rfind("[Event ", 0) == 0) {  // masuk setiap game ketika awal nya "[Event"
-
-                    if (!current_game.empty()) {  // pengecekan di game pertama
-
-                        OrderedDict game_header = parse_game_header(current_game);
-                        // all_games.push_back(game_header);
-
-                        // FILTER GAME YANG SESUAI
-                        if (filter_game(game_header)){
-                            OrderedDict game = parse_game_moves(game_header, current_game);
-                            OrderedDict safe_csv_game = normalize_to_schema(game, CSV_SCHEMA);
-                            all_games.push_back(safe_csv_game);
-                            collected_games++;
-                            
-                            if (all_games.size() >= BATCH_SIZE) {
-                                flush_batch_to_csv(all_games, csv_target);
-                            }
-                        } 
-
-                        current_game.clear();
-                        scanned_games++;
-                        
-                        if (scanned_games % LOG_CHECKPOINT == 0){
-                            string progress = log_progress(scanned_games, collected_games, TOTAL_GAMES, start_time);
-                            cerr << "\r[INFO] " << progress << std::flush;
-                        }
-
-                        if (collected_games >= games_to_read) {
-                            cout << "\n\nTOTAL GAMES :" << collected_games << "\n";
-                            break;
-                        }
-                    }
-                }
+private:
+    // job_collected_<i> / job_csv_bytes_<i>
+    void load_job(const std::string &key, uint64_t value) {
+        static const std::string COLLECTED = "job_collected_", CSV_BYTES = "job_csv_bytes_";
+        bool collected_key = key.rfind(COLLECTED, 0) == 0;
+        if (!collected_key && key.rfind(CSV_BYTES, 0) != 0) return;
+
+        std::string_view digits = std::string_view(key).substr(collected_key ? COLLECTED.size() : CSV_BYTES.size());
+        int index;
+        if (!parse_int(digits, 0, digits.size(), index) || index < 0 || index >= (int)MAX_JOBS) return;
+        if ((size_t)index >= jobs.size()) jobs.resize(index + 1);
+        if (collected_key) jobs[index].collected = value;
+        else jobs[index].csv_bytes = value;
+    }
+};
+
+// Writer satu job: salah satu dari csv / arrow / store
+struct JobOutput {
+    const Job *job = nullptr;
+    std::unique_ptr<CSVWriter> csv;
+    std::unique_ptr<ArrowWriter> arrow;
+    std::unique_ptr<GameStoreWriter> store;
+    GameStoreWriter::Record store_record;
+    std::unique_ptr<NpyWriter> npy;
+    NpyWriter::Record npy_record;
+    bool slot_order = true;              // slot game bisa ditulis langsung
+    std::vector<std::string_view> row;   // kolom yang dipilih job
+    size_t collected = 0;
+    size_t unflushed = 0;
+
+    // job store tidak pernah penuh, semua game yang lolos ditulis
+    bool full() const {
+        return !store && collected >= job->limit;
+    }
+
+    void write(const GameRecord &game) {
+        if (store) {
+            // field header record sama urutannya dengan StoreTag
+            for (int tag = 0; tag < STORE_TAG_COUNT; ++tag) store_record.tags[tag] = game.slots[tag];
+            store_record.moves_uci = game.slots[FIELD_MOVES_UCI];
+            std::string_view error = game.slots[FIELD_REPLAY_ERROR];
+            store_record.truncated = !error.empty() && replay_truncated(error);
+            store_record.unreplayed = !error.empty() && !store_record.truncated;
+            store->append(store_record);
+            collected++;
+            return;
+        }
+        if (npy) {
+            // row tanpa langkah lengkap tidak berguna untuk training
+            if (!game.slots[FIELD_REPLAY_ERROR].empty()) {
+                npy->skip();
+                return;
+            }
+            npy_record.result = game.slots[FIELD_RESULT];
+            npy_record.white_elo = game.slots[FIELD_WHITE_ELO];
+            npy_record.black_elo = game.slots[FIELD_BLACK_ELO];
+            npy_record.time_control = game.slots[FIELD_TIME_CONTROL];
+            npy_record.moves_uci = game.slots[FIELD_MOVES_UCI];
+            npy->append(npy_record);
+            collected++;
+            return;
+        }
+
+        const std::string_view *fields = game.slots.data();
+        size_t count = job->columns.size();
+        if (!slot_order) {
+            for (size_t i = 0; i < job->columns.size(); ++i) row[i] = game.slots[job->columns[i]];
+            fields = row.data();
+            count = row.size();
+        }
 
-                current_game += line;
-                current_game += "\n";
+        if (arrow) {
+            arrow->write_row(fields, count);  // record batch per BATCH_SIZE row
+        } else {
+            if (!csv->header_written) write_csv_header(*job, *csv);
+            csv->write_row(fields, count);
+            if (++unflushed >= BATCH_SIZE) {
+                csv->flush();
+                unflushed = 0;
             }
         }
+        collected++;
     }
 
-    ZSTD_freeDStream(dstream);
+    void close() {
+        if (arrow) arrow->close();
+        if (store) store->close();
+        if (npy) npy->close();
+        if (csv) {
+            if (!csv->header_written) write_csv_header(*job, *csv);  // tetap ada header walau tanpa row
+            csv->flush();
+        }
+    }
+};
 
-    // tampilkan
-    // for (size_t i = 0; i < all_games.size(); ++i) {
+struct OrderedWriter {
+    std::vector<JobOutput> outputs;
+    std::atomic<uint64_t> finished{0};  // bit per job yang sudah mencapai limit, dibaca worker
+    uint64_t all_jobs = 0;
+    Logger *logger = nullptr;  // snapshot statistik tiap LOG_CHECKPOINT
+    ResultPool *results = nullptr;  // hasil yang sudah ditulis dikembalikan ke sini
+    std::chrono::steady_clock::time_point start_time;
+    std::map<size_t, BatchResult> waiting;
+    size_t next_index = 0;
+    size_t scanned_games = 0;
+    size_t collected_games = 0;  // game unik yang ditulis ke minimal satu job
+
+    // checkpoint: hanya disimpan di awal batch, saat semua game sebelumnya sudah ditulis
+    uintmax_t source_size = 0;
+    size_t resumed_scanned = 0;
+    size_t checkpoint_scanned = 0;
+
+    explicit OrderedWriter(std::chrono::steady_clock::time_point start_time) : start_time(start_time) {}
+
+    // resume_bytes: panjang CSV dari checkpoint, 0 untuk mulai baru
+    void add_job(const Job &job, uintmax_t resume_bytes, bool direct_io) {
+        JobOutput output;
+        output.job = &job;
+        output.slot_order = job.slot_order();
+        output.row.resize(job.columns.size());
+        if (job.format == "arrow") {
+            output.arrow = std::make_unique<ArrowWriter>(job.output, arrow_schema(job), BATCH_SIZE);
+        } else if (job.store()) {
+            output.store = std::make_unique<GameStoreWriter>(job.output);
+        } else if (job.npy()) {
+            output.npy = std::make_unique<NpyWriter>(job.output, job.npy_plies, job.shard_rows);
+        } else {
+            output.csv = std::make_unique<CSVWriter>(job.output, resume_bytes, direct_io);
+        }
+        outputs.push_back(std::move(output));
+        all_jobs |= uint64_t(1) << (outputs.size() - 1);
+    }
 
-    //     cout << "\n===== GAME " << (i + 1) << " =====\n";
-    //     const auto &game = all_games[i];
+    void resume_from(const Checkpoint &checkpoint) {
+        scanned_games = resumed_scanned = checkpoint_scanned = checkpoint.scanned;
+        collected_games = checkpoint.collected;
+        for (size_t j = 0; j < outputs.size(); ++j) {
+            outputs[j].collected = checkpoint.jobs[j].collected;
+            if (outputs[j].full()) finish_job(j, scanned_games);
+        }
+    }
 
-    //     for (const auto &key : game.order) {
-    //         std::cout << key << " : " << game.data.at(key) << "\n";
-    //     }
-    // }
+    bool done() const {
+        return finished.load(std::memory_order_relaxed) == all_jobs;
+    }
 
-    // logging
-    auto end_time = std::chrono::steady_clock::now();
-    auto total_sec =
-        std::chrono::duration_cast<std::chrono::seconds>(end_time - start_time).count();
+    // checkpoint hanya untuk CSV, file Arrow baru valid setelah footer ditulis,
+    // dan isi reservoir sampel / opening tree / tabel pemain tidak ikut disimpan
+    bool checkpointable() const {
+        for (const auto &output : outputs) {
+            if (!output.csv || output.job->sampled() || output.job->tree() || output.job->players()) return false;
+        }
+        return true;
+    }
 
-    logger.info("Run finished    : " + FILE_NAME.string(), true);
-    logger.info("Total scanned   : " + std::to_string(scanned_games), true);
-    logger.info("Total collected : " + std::to_string(collected_games), true);
+    // return false jika semua job sudah mencapai limit
+    bool write(BatchResult result) {
+        waiting.emplace(result.index, std::move(result));
+
+        while (!done()) {
+            auto it = waiting.find(next_index);
+            if (it == waiting.end()) break;
+            if (scanned_games - checkpoint_scanned >= CHECKPOINT_GAMES && checkpointable()) {
+                save_checkpoint(it->second.batch.position);
+            }
+            write_in_order(it->second);
+            if (results) results->release(std::move(it->second));
+            waiting.erase(it);  // teks batch dilepas setelah row-nya ditulis
+            next_index++;
+        }
+
+        return !done();
+    }
+
+    void write_in_order(BatchResult &result) {
+        size_t scanned_before = scanned_games;
+        scanned_games = scanned_before + result.scanned;
+
+        // row merujuk teks batch, jadi harus ditulis sebelum batch dilepas
+        auto write_start = std::chrono::steady_clock::now();
+        for (size_t g = 0; g < result.games.size(); ++g) {
+            uint64_t mask = result.job_mask[g] & ~finished.load(std::memory_order_relaxed);
+            if (mask == 0) continue;
+
+            for (size_t j = 0; j < outputs.size(); ++j) {
+                if (!((mask >> j) & 1)) continue;
+                outputs[j].write(result.games[g]);
+                if (outputs[j].full()) finish_job(j, scanned_before + result.game_pos[g] + 1);
+            }
+            collected_games++;
+
+            if (done()) {
+                // berhenti tepat di game terakhir yang dibutuhkan seperti run single-thread
+                scanned_games = scanned_before + result.game_pos[g] + 1;
+                break;
+            }
+        }
+        pipeline_stats.add(STAGE_WRITE, lap_ns(write_start));
+
+        if (done()) {
+            cout << "\n\nTOTAL GAMES :" << collected_games << "\n";
+            return;
+        }
+
+        if (scanned_games / LOG_CHECKPOINT != scanned_before / LOG_CHECKPOINT) {
+            string progress = log_progress(scanned_games, collected_games, TOTAL_GAMES, start_time, resumed_scanned);
+            cerr << "\r[INFO] " << progress << std::flush;
+            if (logger) {
+                logger->stats(stats_json("progress", scanned_games, collected_games, start_time, resumed_scanned));
+            }
+        }
+    }
+
+    // job yang selesai langsung ditutup, worker berhenti mengecek filternya
+    void finish_job(size_t j, size_t scanned) {
+        outputs[j].close();
+        finished.fetch_or(uint64_t(1) << j, std::memory_order_relaxed);
+        if (logger && outputs.size() > 1) {
+            logger->info("Job finished    : " + outputs[j].job->name + " | " + std::to_string(outputs[j].collected)
+                         + " rows, " + std::to_string(scanned) + " scanned");
+        }
+    }
+
+    // Sampel ditulis setelah scan selesai: reservoir semua worker digabung
+    // per stratum, lalu row diurutkan sesuai urutan game di dump
+    void write_samples(const std::vector<JobFilters *> &workers) {
+        auto write_start = std::chrono::steady_clock::now();
+        for (size_t j = 0; j < outputs.size(); ++j) {
+            const Job &job = *outputs[j].job;
+            if (!job.sampled()) continue;
+
+            std::map<std::string_view, std::vector<Reservoir<OwnedRecord> *>> strata;
+            for (JobFilters *worker : workers) {
+                for (auto &entry : worker->samplers[j].strata) strata[entry.first].push_back(&entry.second);
+            }
+
+            std::vector<OwnedRecord *> rows;
+            uint64_t matched = 0;
+            for (const auto &entry : strata) {
+                for (auto *part : entry.second) matched += part->seen;
+
+                std::vector<OwnedRecord *> sample = merge_reservoirs(entry.second, job.limit);
+                rows.insert(rows.end(), sample.begin(), sample.end());
+            }
+            std::sort(rows.begin(), rows.end(), [](const OwnedRecord *a, const OwnedRecord *b) {
+                return a->order < b->order;
+            });
+
+            for (const OwnedRecord *row : rows) outputs[j].write(row->view());
+            collected_games += rows.size();
+            finish_job(j, scanned_games);
+            if (logger) {
+                logger->info("Sample          : " + job.name + " | " + std::to_string(rows.size()) + " rows from "
+                             + std::to_string(matched) + " matching games, " + std::to_string(strata.size())
+                             + " strata", true);
+            }
+        }
+        pipeline_stats.add(STAGE_WRITE, lap_ns(write_start));
+    }
+
+    // Opening tree: tabel semua worker digabung ke tabel dengan setengah budget
+    // job, lalu ditulis per ply dengan posisi paling sering lebih dulu. Langkah
+    // dari posisi awal direkonstruksi lewat parent; kosong jika parent dibuang.
+    void write_trees(const std::vector<JobFilters *> &workers) {
+        auto write_start = std::chrono::steady_clock::now();
+        for (size_t j = 0; j < outputs.size(); ++j) {
+            const Job &job = *outputs[j].job;
+            if (!job.tree()) continue;
+
+            OpeningTree merged((job.tree_memory_mb << 20) / 2, job.tree_plies);
+            for (JobFilters *worker : workers) {
+                merged.merge(*worker->opening_trees[j]);
+                worker->opening_trees[j]->release();
+            }
+
+            std::vector<const TreeEntry *> rows;
+            for (const TreeEntry &entry : merged.slots()) {
+                if (entry.key) rows.push_back(&entry);
+            }
+            std::sort(rows.begin(), rows.end(), [](const TreeEntry *a, const TreeEntry *b) {
+                if (a->ply != b->ply) return a->ply < b->ply;
+                if (a->games() != b->games()) return a->games() > b->games();
+                return a->key < b->key;
+            });
+
+            CSVWriter &csv = *outputs[j].csv;
+            write_csv_header(job, csv);
+            std::vector<uint16_t> path;
+            std::string line, fen;
+            for (const TreeEntry *row : rows) {
+                path.clear();
+                const TreeEntry *entry = row;
+                while (entry && entry->parent && (int)path.size() <= job.tree_plies) {
+                    path.push_back(entry->move);
+                    entry = merged.find(entry->parent);
+                }
+
+                line.clear();
+                fen.clear();
+                if (entry && !entry->parent) {
+                    chess::Board board;
+                    for (auto it = path.rbegin(); it != path.rend(); ++it) {
+                        chess::Move move = chess::Move::unpack(*it);
+                        if (!line.empty()) line += ' ';
+                        chess::Board::append_uci(move, line);
+                        board.make(move);
+                    }
+                    board.append_fen(fen);
+                }
+
+                char key[17], parent[17], score[16];
+                snprintf(key, sizeof(key), "%016llx", (unsigned long long)row->key);
+                snprintf(parent, sizeof(parent), "%016llx", (unsigned long long)row->parent);
+                snprintf(score, sizeof(score), "%.4f", (row->white + row->draws * 0.5) / row->games());
+                std::string ply = std::to_string(row->ply), games = std::to_string(row->games());
+                std::string white = std::to_string(row->white), draws = std::to_string(row->draws);
+                std::string black = std::to_string(row->black);
+                std::string avg_elo = row->elo_games ? std::to_string(row->elo_sum / (2 * row->elo_games)) : "";
+                std::string_view fields[] = { key, row->parent ? parent : "", ply, line, fen, games, white, draws,
+                                              black, score, avg_elo };
+                csv.write_row(fields, TREE_COLUMNS.size());
+                if (++outputs[j].unflushed >= BATCH_SIZE) {
+                    csv.flush();
+                    outputs[j].unflushed = 0;
+                }
+            }
+            outputs[j].collected = rows.size();
+
+            const TreeEntry *root = merged.find(chess::Board().hash());
+            finish_job(j, scanned_games);
+            if (logger) {
+                logger->info("Opening tree    : " + job.name + " | " + std::to_string(rows.size()) + " positions from "
+                             + std::to_string(root ? root->games() : 0) + " games, "
+                             + (merged.evicted_below ? "evicted positions below " + std::to_string(merged.evicted_below)
+                                                       + " games" : std::string("no eviction")), true);
+            }
+        }
+        pipeline_stats.add(STAGE_WRITE, lap_ns(write_start));
+    }
+
+    // Players: shard semua worker digabung ke tabel dengan setengah budget job,
+    // ditulis dengan pemain paling banyak game lebih dulu. favourite_ecos
+    // "B20:12 C00:5": perkiraan SpaceSaving, persis untuk pemain dengan paling
+    // banyak PLAYER_ECOS ECO berbeda, selain itu count bisa lebih (batas atas,
+    // kelebihan <= games / PLAYER_ECOS, bisa beda antar --threads). rating_by_week
+    // rata-rata rating sesudah game per minggu bulan itu, kosong tanpa game.
+    void write_players(const std::vector<JobFilters *> &workers) {
+        auto write_start = std::chrono::steady_clock::now();
+        for (size_t j = 0; j < outputs.size(); ++j) {
+            const Job &job = *outputs[j].job;
+            if (!job.players()) continue;
+
+            PlayerTable merged((job.player_memory_mb << 20) / 2);
+            for (JobFilters *worker : workers) {
+                merged.merge(*worker->player_tables[j]);
+                worker->player_tables[j]->release();
+            }
+
+            std::vector<const PlayerEntry *> rows;
+            uint64_t games = 0, approximate = 0;
+            for (const PlayerEntry &entry : merged.slots()) {
+                if (!entry.key) continue;
+                rows.push_back(&entry);
+                games += entry.white_games;  // tiap game dihitung sekali, dari sisi putih
+                if (entry.eco_error) approximate++;
+            }
+            std::sort(rows.begin(), rows.end(), [](const PlayerEntry *a, const PlayerEntry *b) {
+                if (a->games != b->games) return a->games > b->games;
+                return a->name < b->name;
+            });
+
+            CSVWriter &csv = *outputs[j].csv;
+            write_csv_header(job, csv);
+            std::string numbers[14], ecos, weeks;
+            for (const PlayerEntry *row : rows) {
+                auto rating = [](int16_t value) { return value == INT16_MIN ? std::string() : std::to_string(value); };
+                bool rated = row->first_rating != INT16_MIN;
+                char score[16] = "";
+                uint32_t decided = row->wins + row->draws + row->losses;
+                if (decided) snprintf(score, sizeof(score), "%.4f", (row->wins + row->draws * 0.5) / decided);
+
+                numbers[0] = std::to_string(row->games);
+                numbers[1] = std::to_string(row->white_games);
+                numbers[2] = std::to_string(row->wins);
+                numbers[3] = std::to_string(row->draws);
+                numbers[4] = std::to_string(row->losses);
+                numbers[5] = rating(row->first_rating);
+                numbers[6] = rating(row->last_rating);
+                numbers[7] = rated ? rating(row->min_rating) : std::string();
+                numbers[8] = rated ? rating(row->max_rating) : std::string();
+                for (int i = 0; i < TIME_CLASS_COUNT; ++i) numbers[9 + i] = std::to_string(row->time_classes[i]);
+
+                // counter ECO terbesar dulu, maksimal 3
+                int order[PLAYER_ECOS];
+                for (int i = 0; i < PLAYER_ECOS; ++i) order[i] = i;
+                std::sort(order, order + PLAYER_ECOS, [&](int a, int b) {
+                    if (row->eco_counts[a] != row->eco_counts[b]) return row->eco_counts[a] > row->eco_counts[b];
+                    return row->ecos[a] < row->ecos[b];
+                });
+                ecos.clear();
+                for (int i = 0; i < 3; ++i) {
+                    int slot = order[i];
+                    if (!row->ecos[slot] || !row->eco_counts[slot]) break;
+                    int code = row->ecos[slot] - 1;
+                    if (!ecos.empty()) ecos += ' ';
+                    ecos += (char)('A' + code / 100);
+                    ecos += (char)('0' + code / 10 % 10);
+                    ecos += (char)('0' + code % 10);
+                    ecos += ':';
+                    ecos += std::to_string(row->eco_counts[slot]);
+                }
+
+                weeks.clear();
+                for (int w = 0; w < PLAYER_WEEKS; ++w) {
+                    if (w) weeks += ' ';
+                    if (row->week_games[w]) weeks += std::to_string(row->week_rating_sum[w] / row->week_games[w]);
+                }
+
+                std::string_view fields[] = { row->name, numbers[0], numbers[1], numbers[2], numbers[3], numbers[4],
+                                              score, numbers[5], numbers[6], numbers[7], numbers[8], numbers[9],
+                                              numbers[10], numbers[11], numbers[12], numbers[13], ecos, weeks };
+                csv.write_row(fields, PLAYER_COLUMNS.size());
+                if (++outputs[j].unflushed >= BATCH_SIZE) {
+                    csv.flush();
+                    outputs[j].unflushed = 0;
+                }
+            }
+            outputs[j].collected = rows.size();
+
+            finish_job(j, scanned_games);
+            if (logger) {
+                logger->info("Players         : " + job.name + " | " + std::to_string(rows.size()) + " players from "
+                             + std::to_string(games) + " games, favourite_ecos approximate (upper bound) for "
+                             + std::to_string(approximate) + " players, "
+                             + (merged.evicted_below ? "evicted players below " + std::to_string(merged.evicted_below)
+                                                       + " games" : std::string("no eviction")), true);
+            }
+        }
+        pipeline_stats.add(STAGE_WRITE, lap_ns(write_start));
+    }
+
+    void save_checkpoint(const StreamPosition &position) {
+        Checkpoint checkpoint;
+        checkpoint.source_size = source_size;
+        checkpoint.jobs_hash = jobs_hash(JOBS);
+        checkpoint.position = position;
+        checkpoint.scanned = scanned_games;
+        checkpoint.collected = collected_games;
+        for (auto &output : outputs) {
+            output.csv->flush();
+            checkpoint.jobs.push_back({ output.collected, output.csv->bytes() });
+        }
+        checkpoint.csv_bytes = checkpoint.jobs[0].csv_bytes;
+        checkpoint.save(CHECKPOINT_PATH);
+        checkpoint_scanned = scanned_games;
+    }
+
+    void finish() {
+        auto write_start = std::chrono::steady_clock::now();
+        for (auto &output : outputs) {
+            output.close();
+            if (output.store && logger) {
+                std::error_code ignored;
+                uintmax_t megabytes = fs::file_size(output.job->output, ignored) >> 20;
+                logger->info("Game store      : " + output.job->name + " | " + std::to_string(output.store->games())
+                             + " games, " + std::to_string(output.store->plies()) + " plies, "
+                             + std::to_string(output.store->truncated()) + " truncated at illegal SAN, "
+                             + std::to_string(output.store->unreplayed()) + " not replayable, "
+                             + std::to_string(megabytes) + " MB", true);
+            }
+            if (output.npy && logger) {
+                logger->info("NPY shards      : " + output.job->name + " | " + std::to_string(output.npy->shards())
+                             + " shards, " + std::to_string(output.npy->rows_written()) + " rows, "
+                             + std::to_string(output.npy->rows_skipped()) + " games skipped (replay error)", true);
+            }
+        }
+        pipeline_stats.add(STAGE_WRITE, lap_ns(write_start));
+    }
+};
+
+// Awal satu frame zstd di dump
+struct FrameEntry {
+    uint64_t compressed_offset = 0;  // offset di file .zst
+    uint64_t frame_offset = 0;       // offset decompressed
+};
+
+// Index semua frame zstd di dump (sidecar <source>.frames), dibuat sekali.
+// Entry terakhir adalah sentinel: ukuran file dan total ukuran decompressed.
+struct FrameIndex {
+    uintmax_t source_size = 0;
+    std::vector<FrameEntry> frames;
+
+    size_t frame_count() const {
+        return frames.empty() ? 0 : frames.size() - 1;
+    }
+
+    // frame terakhir yang mulai di atau sebelum offset decompressed
+    size_t frame_at(uint64_t stream_offset) const {
+        auto it = std::upper_bound(frames.begin(), frames.begin() + frame_count(), stream_offset,
+            [](uint64_t offset, const FrameEntry &frame) { return offset < frame.frame_offset; });
+        return it == frames.begin() ? 0 : (it - frames.begin()) - 1;
+    }
+
+    StreamPosition position_at(uint64_t stream_offset) const {
+        const FrameEntry &frame = frames[frame_at(stream_offset)];
+        StreamPosition position;
+        position.compressed_offset = frame.compressed_offset;
+        position.frame_offset = frame.frame_offset;
+        position.stream_offset = stream_offset;
+        return position;
+    }
+
+    void save(const fs::path &path) const {
+        std::ofstream out(path, std::ios::trunc);
+        out << "source_size " << source_size << "\n"
+            << "frames " << frame_count() << "\n";
+        for (const auto &frame : frames) {
+            out << frame.compressed_offset << " " << frame.frame_offset << "\n";
+        }
+        if (!out) {
+            throw std::runtime_error("Cannot write frame index");
+        }
+    }
+
+    // false jika index tidak ada atau dibuat untuk file lain
+    bool load(const fs::path &path, uintmax_t expected_source_size) {
+        std::ifstream in(path);
+        std::string key;
+        size_t count = 0;
+        if (!(in >> key >> source_size) || key != "source_size" || source_size != expected_source_size) return false;
+        if (!(in >> key >> count) || key != "frames") return false;
+
+        frames.resize(count + 1);
+        for (auto &frame : frames) {
+            if (!(in >> frame.compressed_offset >> frame.frame_offset)) return false;
+        }
+        return frames.back().compressed_offset == source_size;
+    }
+};
+
+static uint32_t read_le32(const unsigned char *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Jalan dari header frame ke header frame (dan header block di dalamnya) tanpa
+// dekompresi. Hanya frame tanpa content size di header yang harus didekompres.
+bool build_frame_index(const fs::path &source_path, FrameIndex &index) {
+    std::ifstream in(source_path, std::ios::binary);
+    if (!in) return false;
+
+    index.source_size = fs::file_size(source_path);
+    index.frames.clear();
+
+    uint64_t offset = 0;
+    uint64_t output = 0;
+
+    while (offset < index.source_size) {
+        unsigned char header[18];  // ukuran maksimal frame header
+        in.seekg(offset);
+        in.read((char *)header, sizeof(header));
+        size_t got = in.gcount();
+        in.clear();
+        if (got < 8) return false;
+
+        uint32_t magic = read_le32(header);
+        if ((magic & ZSTD_MAGIC_SKIPPABLE_MASK) == ZSTD_MAGIC_SKIPPABLE_START) {
+            offset += 8 + read_le32(header + 4);
+            continue;
+        }
+        if (magic != ZSTD_MAGICNUMBER) return false;
+
+        // Frame_Header_Descriptor, lihat RFC 8878 bagian 3.1.1.1
+        unsigned char descriptor = header[4];
+        int content_size_flag = descriptor >> 6;
+        bool single_segment = descriptor & 0x20;
+        bool has_checksum = descriptor & 0x04;
+        int dict_id_flag = descriptor & 0x03;
+
+        size_t dict_id_size = dict_id_flag == 3 ? 4 : dict_id_flag;
+        size_t content_size_size = content_size_flag == 0 ? (single_segment ? 1 : 0) : (1u << content_size_flag);
+        size_t header_size = 5 + (single_segment ? 0 : 1) + dict_id_size + content_size_size;
+        if (got < header_size) return false;
+
+        unsigned long long content_size = ZSTD_getFrameContentSize(header, header_size);
+        if (content_size == ZSTD_CONTENTSIZE_ERROR) return false;
+
+        // block header 3 byte: last block, tipe, ukuran
+        uint64_t pos = offset + header_size;
+        for (;;) {
+            unsigned char block[3];
+            in.seekg(pos);
+            in.read((char *)block, 3);
+            if (in.gcount() != 3) return false;
+
+            uint32_t block_header = block[0] | (block[1] << 8) | (block[2] << 16);
+            bool last_block = block_header & 1;
+            int block_type = (block_header >> 1) & 3;
+            uint32_t block_size = block_header >> 3;
+            if (block_type == 3) return false;
+
+            pos += 3 + (block_type == 1 ? 1 : block_size);  // RLE hanya menyimpan 1 byte
+            if (last_block) break;
+        }
+        if (has_checksum) pos += 4;
+        if (pos > index.source_size) return false;
+
+        if (content_size == ZSTD_CONTENTSIZE_UNKNOWN) {
+            // content size tidak ditulis compressor: hitung dengan dekompresi frame ini saja
+            std::vector<char> src(pos - offset);
+            in.seekg(offset);
+            in.read(src.data(), src.size());
+            if ((size_t)in.gcount() != src.size()) return false;
+
+            ZSTD_DStream *dstream = ZSTD_createDStream();
+            ZSTD_initDStream(dstream);
+            std::vector<char> scratch(ZSTD_DStreamOutSize());
+            ZSTD_inBuffer input{ src.data(), src.size(), 0 };
+            content_size = 0;
+            size_t ret = 1;
+            while (ret != 0) {
+                ZSTD_outBuffer out_buf{ scratch.data(), scratch.size(), 0 };
+                ret = ZSTD_decompressStream(dstream, &out_buf, &input);
+                if (ZSTD_isError(ret) || (out_buf.pos == 0 && input.pos == input.size && ret != 0)) {
+                    ZSTD_freeDStream(dstream);
+                    return false;
+                }
+                content_size += out_buf.pos;
+            }
+            ZSTD_freeDStream(dstream);
+        }
+
+        index.frames.push_back({ offset, output });
+        output += content_size;
+        offset = pos;
+    }
+
+    index.frames.push_back({ offset, output });  // sentinel
+    return true;
+}
+
+// Decompress streaming satu thread dari posisi start, hasilnya dipotong jadi batch.
+// fin sudah di posisi start.compressed_offset; prefix = byte yang sudah dibaca
+// dari fin untuk cek magic (stdin tidak bisa seek). Return false jika data zstd rusak.
+template <typename Dispatch>
+bool decompress_stream(std::istream &fin, const StreamPosition &start, std::string_view prefix,
+                       Dispatch &&dispatch, const std::atomic<bool> &stop) {
+
+    // Bisa dekompres chunk per chunk
+    ZSTD_DStream* dstream = ZSTD_createDStream();
+    ZSTD_initDStream(dstream);
+    if (!dstream) {
+        cerr << "[ERROR] Cannot create ZSTD context\n";
+        return false;
+    }
+
+    const size_t IN_BUF_SIZE = ZSTD_DStreamInSize();
+    const size_t OUT_BUF_SIZE = ZSTD_DStreamOutSize();
+
+    vector<char> inBuf(IN_BUF_SIZE);
+
+    // batch yang sedang diisi langsung oleh ZSTD, selalu disisakan
+    // ruang minimal satu output chunk
+    const size_t BATCH_CAPACITY = BATCH_BYTES + OUT_BUF_SIZE;
+    std::shared_ptr<BufferPool> buffers = std::make_shared<BufferPool>(BATCH_CAPACITY);
+    GameBatch pending = buffers->batch();
+    pending.position = start;
+
+    // awal frame zstd yang sudah dilewati, untuk posisi resume batch berikutnya
+    std::deque<StreamPosition> frames{ start };
+    uint64_t input_offset = start.compressed_offset;  // offset file awal inBuf
+    uint64_t output_offset = start.frame_offset;      // offset decompressed yang sudah keluar
+
+    // saat resume, teks sebelum awal batch checkpoint dibuang
+    uint64_t skip_bytes = start.stream_offset - start.frame_offset;
+
+    if (!prefix.empty()) memcpy(inBuf.data(), prefix.data(), prefix.size());
+    ZSTD_inBuffer input{ inBuf.data(), prefix.size(), 0 };
+    bool flushed = true;  // false jika ZSTD masih menyimpan output di buffer internal
+    bool failed = false;
+
+    // statistik dikumpulkan lokal, ditambahkan ke pipeline_stats tiap batch
+    uint64_t stage_ns[STAGE_COUNT] = {};
+    uint64_t read_bytes = 0;
+    uint64_t output_bytes = 0;
+    auto publish_stats = [&]() {
+        for (int i = 0; i < STAGE_COUNT; ++i) pipeline_stats.add((Stage)i, stage_ns[i]);
+        pipeline_stats.compressed_bytes += read_bytes;
+        pipeline_stats.decompressed_bytes += output_bytes;
+        std::fill(std::begin(stage_ns), std::end(stage_ns), 0);
+        read_bytes = output_bytes = 0;
+    };
+    auto clock = std::chrono::steady_clock::now();
+
+    while (!stop) {
+        if (input.pos == input.size && flushed) {
+            input_offset += input.size;
+            lap_ns(clock);
+            fin.read(inBuf.data(), inBuf.size());
+            size_t bytes_read = fin.gcount();
+            stage_ns[STAGE_READ] += lap_ns(clock);
+            read_bytes += bytes_read;
+            if (bytes_read == 0) break;
+            input = ZSTD_inBuffer{ inBuf.data(), bytes_read, 0 };
+        }
+
+        if (pending.capacity - pending.size < OUT_BUF_SIZE) {
+            pending.grow(pending.capacity * 2);  // satu game lebih besar dari batch
+        }
+
+        ZSTD_outBuffer output{ pending.data + pending.size, pending.capacity - pending.size, 0 };
+        lap_ns(clock);
+        size_t ret = ZSTD_decompressStream(dstream, &output, &input);
+        stage_ns[STAGE_DECOMPRESS] += lap_ns(clock);
+        output_bytes += output.pos;
+
+        if (ZSTD_isError(ret)) {
+            cerr << "[ERROR] ZSTD decompress error: "
+                 << ZSTD_getErrorName(ret) << endl;
+            failed = true;
+            break;
+        }
+
+        output_offset += output.pos;
+        flushed = output.pos < output.size;
+
+        // ret == 0: frame selesai, frame berikutnya mulai dari posisi input ini
+        if (ret == 0) {
+            StreamPosition frame;
+            frame.compressed_offset = input_offset + input.pos;
+            frame.frame_offset = output_offset;
+            frames.push_back(frame);
+        }
+
+        size_t produced = output.pos;
+        if (skip_bytes > 0) {
+            size_t drop = std::min<uint64_t>(skip_bytes, produced);
+            memmove(output.dst, (char *)output.dst + drop, produced - drop);
+            produced -= drop;
+            skip_bytes -= drop;
+        }
+
+        pending.size += produced;
+        if (pending.size < BATCH_BYTES) continue;
+
+        // potong di awal game terakhir, hanya game itu yang disalin ke batch berikutnya
+        lap_ns(clock);
+        size_t cut = pending.text().rfind("\n[Event ");
+        if (cut == std::string_view::npos) continue;
+
+        GameBatch next = buffers->batch();
+        next.size = pending.size - (cut + 1);
+        memcpy(next.data, pending.data + cut + 1, next.size);
+        pending.size = cut + 1;
+        stage_ns[STAGE_SPLIT] += lap_ns(clock);
+
+        // frame terakhir yang mulai sebelum batch berikutnya
+        uint64_t next_offset = pending.position.stream_offset + cut + 1;
+        while (frames.size() > 1 && frames[1].frame_offset <= next_offset) {
+            frames.pop_front();
+        }
+        next.position = frames.front();
+        next.position.stream_offset = next_offset;
+
+        publish_stats();
+        dispatch(std::move(pending));
+        pending = std::move(next);
+    }
+    publish_stats();
+
+    // game terakhir tidak diikuti "[Event"
+    if (!stop && !failed && pending.size > 0) {
+        dispatch(std::move(pending));
+    }
+
+    ZSTD_freeDStream(dstream);
+    return !failed;
+}
+
+// PGN tanpa kompresi dari stream (stdin, mis. dari zstdcat / pzstd -d): blok
+// besar dibaca langsung ke buffer batch dari BufferPool, batch berikutnya
+// diisi selagi worker memproses batch sebelumnya. Saat antrian worker penuh
+// dispatch menunggu dan stdin berhenti dibaca, jadi producer di depan pipe
+// ikut tertahan. Return false jika stream error.
+template <typename Dispatch>
+bool read_plain_stream(std::istream &in, std::string_view prefix, Dispatch &&dispatch, const std::atomic<bool> &stop) {
+    const size_t READ_BYTES = 1 << 20;
+    std::shared_ptr<BufferPool> buffers = std::make_shared<BufferPool>(BATCH_BYTES + READ_BYTES);
+    GameBatch pending = buffers->batch();
+    if (!prefix.empty()) memcpy(pending.data, prefix.data(), prefix.size());
+    pending.size = prefix.size();
+
+    auto clock = std::chrono::steady_clock::now();
+    while (!stop) {
+        if (pending.capacity - pending.size < READ_BYTES) {
+            pending.grow(pending.capacity * 2);  // satu game lebih besar dari batch
+        }
+        lap_ns(clock);
+        in.read(pending.data + pending.size, READ_BYTES);
+        size_t bytes_read = in.gcount();
+        pipeline_stats.add(STAGE_READ, lap_ns(clock));
+        pipeline_stats.compressed_bytes += bytes_read;
+        pipeline_stats.decompressed_bytes += bytes_read;
+        if (bytes_read == 0) break;
+
+        pending.size += bytes_read;
+        if (pending.size < BATCH_BYTES) continue;
+
+        size_t cut = pending.text().rfind("\n[Event ");
+        if (cut == std::string_view::npos) continue;
+
+        GameBatch next = buffers->batch();
+        next.size = pending.size - (cut + 1);
+        memcpy(next.data, pending.data + cut + 1, next.size);
+        pending.size = cut + 1;
+
+        uint64_t next_offset = pending.position.stream_offset + cut + 1;
+        next.position = { next_offset, next_offset, next_offset };
+        pipeline_stats.add(STAGE_SPLIT, lap_ns(clock));
+
+        dispatch(std::move(pending));
+        pending = std::move(next);
+    }
+
+    // game terakhir tidak diikuti "[Event"
+    if (!stop && !in.bad() && pending.size > 0) {
+        dispatch(std::move(pending));
+    }
+    return !in.bad();
+}
+
+// .pgn tanpa kompresi yang di-mmap: batch berupa view ke mapping (tanpa
+// salinan dan tanpa decompressor), dipotong di "[Event " setelah BATCH_BYTES.
+// Offset decompressed = offset file, jadi resume langsung ke awal batch.
+template <typename Dispatch>
+void split_mapped(std::string_view text, const StreamPosition &start, Dispatch &&dispatch,
+                  const std::atomic<bool> &stop) {
+    auto clock = std::chrono::steady_clock::now();
+    size_t pos = std::min<uint64_t>(start.stream_offset, text.size());
+    while (pos < text.size() && !stop) {
+        size_t cut = text.size();
+        if (text.size() - pos > BATCH_BYTES) {
+            size_t found = text.find("\n[Event ", pos + BATCH_BYTES);
+            if (found != std::string_view::npos) cut = found + 1;
+        }
+
+        GameBatch batch(std::shared_ptr<char[]>(), text.substr(pos, cut - pos));
+        batch.position = { pos, pos, pos };
+        pipeline_stats.compressed_bytes += cut - pos;
+        pipeline_stats.decompressed_bytes += cut - pos;
+        pipeline_stats.add(STAGE_SPLIT, lap_ns(clock));
+
+        dispatch(std::move(batch));
+        lap_ns(clock);
+        pos = cut;
+    }
+}
+
+// Decompress range frame yang saling lepas di beberapa thread sekaligus.
+// Range disambung lagi sesuai urutan: game yang terpotong di batas range
+// disalin jadi satu batch kecil, sisanya batch adalah view ke buffer range.
+// Return false jika data zstd rusak.
+template <typename Dispatch>
+bool decompress_frames(const fs::path &source_path, const FrameIndex &index, const StreamPosition &start,
+                       unsigned threads, Dispatch &&dispatch, const std::atomic<bool> &stop) {
+    // kelompokkan frame berurutan sampai minimal RANGE_BYTES teks per range
+    std::vector<std::pair<size_t, size_t>> ranges;
+    size_t first = index.frame_at(start.stream_offset);
+    for (size_t i = first; i < index.frame_count();) {
+        size_t j = i + 1;
+        while (j < index.frame_count() &&
+               index.frames[j].frame_offset - index.frames[i].frame_offset < RANGE_BYTES) {
+            j++;
+        }
+        ranges.emplace_back(i, j);
+        i = j;
+    }
+
+    struct DecodedRange {
+        std::shared_ptr<char[]> buffer;
+        size_t size = 0;
+        bool ok = false;
+    };
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::map<size_t, DecodedRange> decoded;
+    size_t next_task = 0;
+    size_t consumed = 0;
+    bool finished = false;
+    const size_t window = threads + 2;  // batas range yang ditahan di memori
+
+    std::vector<std::thread> decoders;
+    for (unsigned t = 0; t < threads; ++t) {
+        decoders.emplace_back([&]() {
+            std::ifstream in(source_path, std::ios::binary);
+            ZSTD_DCtx *dctx = ZSTD_createDCtx();
+            std::vector<char> src;
+
+            for (;;) {
+                size_t task;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cv.wait(lock, [&] { return finished || next_task >= ranges.size() || next_task < consumed + window; });
+                    if (finished || next_task >= ranges.size()) break;
+                    task = next_task++;
+                }
+
+                const FrameEntry &begin = index.frames[ranges[task].first];
+                const FrameEntry &end = index.frames[ranges[task].second];
+
+                DecodedRange range;
+                range.size = end.frame_offset - begin.frame_offset;
+                range.buffer.reset(new char[range.size]);
+
+                auto clock = std::chrono::steady_clock::now();
+                src.resize(end.compressed_offset - begin.compressed_offset);
+                in.seekg(begin.compressed_offset);
+                in.read(src.data(), src.size());
+                pipeline_stats.add(STAGE_READ, lap_ns(clock));
+                pipeline_stats.compressed_bytes += in.gcount();
+
+                if ((size_t)in.gcount() == src.size()) {
+                    size_t ret = ZSTD_decompressDCtx(dctx, range.buffer.get(), range.size, src.data(), src.size());
+                    pipeline_stats.add(STAGE_DECOMPRESS, lap_ns(clock));
+                    pipeline_stats.decompressed_bytes += range.size;
+                    range.ok = !ZSTD_isError(ret) && ret == range.size;
+                    if (ZSTD_isError(ret)) {
+                        cerr << "[ERROR] ZSTD decompress error: " << ZSTD_getErrorName(ret) << endl;
+                    }
+                }
+                in.clear();
+
+                std::lock_guard<std::mutex> lock(mutex);
+                decoded.emplace(task, std::move(range));
+                cv.notify_all();
+            }
+
+            ZSTD_freeDCtx(dctx);
+        });
+    }
+
+    // waktu split: kerja thread ini di luar dispatch dan menunggu decoder
+    auto clock = std::chrono::steady_clock::now();
+    auto timed_dispatch = [&](GameBatch &&batch) {
+        pipeline_stats.add(STAGE_SPLIT, lap_ns(clock));
+        dispatch(std::move(batch));
+        lap_ns(clock);
+    };
+
+    auto dispatch_copy = [&](const std::string &text, uint64_t offset) {
+        GameBatch batch(text.size());
+        memcpy(batch.data, text.data(), text.size());
+        batch.size = text.size();
+        batch.position = index.position_at(offset);
+        timed_dispatch(std::move(batch));
+    };
+
+    // game yang belum selesai di ujung range sebelumnya
+    std::string carry;
+    uint64_t carry_offset = start.stream_offset;
+    bool ok = true;
+
+    for (size_t r = 0; r < ranges.size() && !stop; ++r) {
+        DecodedRange range;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&] { return decoded.count(r) > 0; });
+            range = std::move(decoded[r]);
+            decoded.erase(r);
+            consumed++;
+            cv.notify_all();
+        }
+        lap_ns(clock);
+        if (!range.ok) {
+            ok = false;
+            break;
+        }
+
+        std::string_view text(range.buffer.get(), range.size);
+        uint64_t base = index.frames[ranges[r].first].frame_offset;
+
+        // saat resume, range pertama dimulai tepat di awal batch checkpoint
+        size_t begin = r == 0 ? start.stream_offset - base : 0;
+
+        size_t game_start;
+        if (begin > 0 || (text.rfind("[Event ", 0) == 0 && (carry.empty() || carry.back() == '\n'))) {
+            game_start = begin;
+        } else {
+            size_t found = text.find("\n[Event ");
+            game_start = found == std::string_view::npos ? found : found + 1;
+        }
+
+        if (game_start == std::string_view::npos) {
+            carry.append(text);  // range ini hanya potongan satu game panjang
+            continue;
+        }
+
+        carry.append(text.substr(begin, game_start - begin));
+        if (!carry.empty()) dispatch_copy(carry, carry_offset);
+        carry.clear();
+
+        // game terakhir range ini bisa berlanjut ke range berikutnya
+        size_t last = text.rfind("\n[Event ");
+        size_t tail = last == std::string_view::npos || last + 1 < game_start ? game_start : last + 1;
+
+        size_t pos = game_start;
+        while (pos < tail && !stop) {
+            size_t cut = tail;
+            if (tail - pos > BATCH_BYTES) {
+                size_t found = text.find("\n[Event ", pos + BATCH_BYTES);
+                if (found != std::string_view::npos) cut = std::min(tail, found + 1);
+            }
+
+            GameBatch batch(range.buffer, text.substr(pos, cut - pos));
+            batch.position = index.position_at(base + pos);
+            timed_dispatch(std::move(batch));
+            pos = cut;
+        }
+
+        carry.assign(text.substr(tail));
+        carry_offset = base + tail;
+        pipeline_stats.add(STAGE_SPLIT, lap_ns(clock));
+    }
+
+    if (ok && !stop && !carry.empty()) {
+        dispatch_copy(carry, carry_offset);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished = true;
+        cv.notify_all();
+    }
+    for (auto &decoder : decoders) decoder.join();
+
+    return ok;
+}
+
+struct Options {
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    bool resume = false;
+    bool direct_io = false;  // CSV ditulis dengan O_DIRECT (Linux)
+    std::string format = "csv";  // csv | arrow | tree | players | store | npy
+    std::string filter = DEFAULT_FILTER;
+    std::string columns;     // kosong = kolom default
+    SampleMode sample = SampleMode::FIRST;
+    uint64_t seed = 1;
+    int tree_plies = TREE_PLIES;
+    size_t tree_memory_mb = TREE_MEMORY_MB;
+    size_t player_memory_mb = PLAYER_MEMORY_MB;
+    int npy_plies = NPY_PLIES;
+    size_t shard_rows = NPY_SHARD_ROWS;
+    fs::path manifest;       // banyak job dalam satu pass, menggantikan opsi job di bawah
+    bool job_options = false;  // opsi job (--filter, --output, ...) diberikan
+    size_t limit = games_to_read;
+    fs::path input = SOURCE_PATH;
+    fs::path output = OUTPUT_PATH;
+    fs::path log = "logs/parser.log";  // relatif ke BASE_PATH
+};
+
+bool parse_args(int argc, char **argv, Options &options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        std::string value;
+
+        if (arg == "--resume") {
+            options.resume = true;
+            continue;
+        }
+        if (arg == "--direct-io") {
+            options.direct_io = true;
+            continue;
+        }
+
+        size_t eq = arg.find('=');
+        if (eq != std::string::npos) {
+            value = arg.substr(eq + 1);
+            arg = arg.substr(0, eq);
+        } else if (i + 1 < argc) {
+            value = argv[++i];
+        }
+
+        if (arg == "--format" || arg == "--filter" || arg == "--output" || arg == "--limit" || arg == "--sample" ||
+            arg == "--seed" || arg == "--columns" || arg == "--tree-plies" || arg == "--tree-memory" ||
+            arg == "--player-memory" || arg == "--max-plies" || arg == "--shard-rows") {
+            options.job_options = true;
+        }
+
+        if (arg == "--format") {
+            if (value != "csv" && value != "arrow" && value != "tree" && value != "players" && value != "store" &&
+                value != "npy") {
+                cerr << "[ERROR] Invalid --format value: " << value << " (csv, arrow, tree, players, store or npy)" << endl;
+                return false;
+            }
+            options.format = value;
+        } else if (arg == "--tree-plies") {
+            int plies;
+            if (!parse_int(value, 0, value.size(), plies) || plies < 0 || plies > 255) {
+                cerr << "[ERROR] Invalid --tree-plies value: " << value << " (0-255)" << endl;
+                return false;
+            }
+            options.tree_plies = plies;
+        } else if (arg == "--tree-memory") {
+            int memory;
+            if (!parse_int(value, 0, value.size(), memory) || memory < 1) {
+                cerr << "[ERROR] Invalid --tree-memory value: " << value << " (MB)" << endl;
+                return false;
+            }
+            options.tree_memory_mb = memory;
+        } else if (arg == "--player-memory") {
+            int memory;
+            if (!parse_int(value, 0, value.size(), memory) || memory < 1) {
+                cerr << "[ERROR] Invalid --player-memory value: " << value << " (MB)" << endl;
+                return false;
+            }
+            options.player_memory_mb = memory;
+        } else if (arg == "--max-plies") {
+            int plies;
+            if (!parse_int(value, 0, value.size(), plies) || plies < 1 || plies > 4096) {
+                cerr << "[ERROR] Invalid --max-plies value: " << value << " (1-4096)" << endl;
+                return false;
+            }
+            options.npy_plies = plies;
+        } else if (arg == "--shard-rows") {
+            int rows;
+            if (!parse_int(value, 0, value.size(), rows) || rows < 1) {
+                cerr << "[ERROR] Invalid --shard-rows value: " << value << endl;
+                return false;
+            }
+            options.shard_rows = rows;
+        } else if (arg == "--filter") {
+            options.filter = value;
+        } else if (arg == "--columns") {
+            options.columns = value;
+        } else if (arg == "--sample") {
+            if (!parse_sample_mode(value, options.sample)) {
+                cerr << "[ERROR] Invalid --sample value: " << value << " (first, reservoir, elo, eco or time_control)" << endl;
+                return false;
+            }
+        } else if (arg == "--seed") {
+            int seed;
+            if (!parse_int(value, 0, value.size(), seed) || seed < 0) {
+                cerr << "[ERROR] Invalid --seed value: " << value << endl;
+                return false;
+            }
+            options.seed = seed;
+        } else if (arg == "--manifest") {
+            options.manifest = value;
+        } else if (arg == "--input") {
+            options.input = value;
+        } else if (arg == "--output") {
+            options.output = value;
+        } else if (arg == "--log") {
+            options.log = value;
+        } else if (arg == "--limit") {
+            int limit;
+            if (!parse_int(value, 0, value.size(), limit) || limit < 1) {
+                cerr << "[ERROR] Invalid --limit value: " << value << endl;
+                return false;
+            }
+            options.limit = limit;
+        } else if (arg == "--scanner") {
+            if (!pgn_scan::set_kernel(value)) {
+                std::string names;
+                for (const pgn_scan::Kernel &kernel : pgn_scan::available_kernels()) {
+                    names += (names.empty() ? "" : ", ") + std::string(kernel.name);
+                }
+                cerr << "[ERROR] Invalid --scanner value: " << value << " (available: " << names << ")" << endl;
+                return false;
+            }
+        } else if (arg == "--threads") {
+            int threads;
+            if (!parse_int(value, 0, value.size(), threads) || threads < 1) {
+                cerr << "[ERROR] Invalid --threads value: " << value << endl;
+                return false;
+            }
+            options.threads = threads;
+        } else {
+            cerr << "[ERROR] Unknown option: " << arg << endl;
+            cerr << "Usage: generate_data [--threads N] [--format csv|arrow|tree|players|store|npy] [--resume] [--direct-io]\n"
+                    "                     [--scanner avx2|sse2|scalar]\n"
+                    "                     [--input FILE.pgn.zst|FILE.pgn|-] [--output FILE.csv] [--limit N] [--log FILE]\n"
+                    "                     [--filter \"WhiteElo>=2200 && base in [180,300] && ECO ~ B2*\"]\n"
+                    "                     [--sample first|reservoir|elo|eco|time_control] [--seed N]\n"
+                    "                     [--tree-plies N] [--tree-memory MB] [--player-memory MB]\n"
+                    "                     [--max-plies N] [--shard-rows N]\n"
+                    "                     [--columns default,replay,annotations | link,white_elo,clocks,...]\n"
+                    "                     [--manifest JOBS.manifest]" << endl;
+            return false;
+        }
+    }
+
+    if (!options.manifest.empty() && options.job_options) {
+        cerr << "[ERROR] --manifest cannot be combined with --filter, --output, --format, --limit, --sample, --seed, --columns\n"
+                "        or --tree-plies / --tree-memory / --player-memory / --max-plies / --shard-rows" << endl;
+        return false;
+    }
+    return true;
+}
+
+// daftar kolom dipisah koma (nama kolom CSV), kosong = kolom default.
+// "default" = semua kolom default, "replay" = semua kolom replay,
+// "annotations" = semua kolom [%clk] / [%eval].
+bool parse_columns(std::string_view text, std::vector<Field> &columns) {
+    columns.clear();
+    if (text.find_first_not_of(" \t") == std::string_view::npos) text = "default";
+
+    size_t pos = 0;
+    while (pos <= text.size()) {
+        size_t comma = std::min(text.find(',', pos), text.size());
+        std::string_view name = text.substr(pos, comma - pos);
+        name.remove_prefix(std::min(name.find_first_not_of(" \t"), name.size()));
+        name = name.substr(0, name.find_last_not_of(" \t") + 1);
+
+        pos = comma + 1;
+        if (name == "default" || name == "replay" || name == "annotations") {
+            int begin = name == "default" ? 0 : name == "replay" ? DEFAULT_FIELD_COUNT : REPLAY_FIELD_END;
+            int end = name == "default" ? DEFAULT_FIELD_COUNT : name == "replay" ? REPLAY_FIELD_END : FIELD_COUNT;
+            for (int i = begin; i < end; ++i) columns.push_back((Field)i);
+            continue;
+        }
+
+        int found = FIELD_UNKNOWN;
+        for (int i = 0; i < FIELD_COUNT; ++i) {
+            if (CSV_SCHEMA[i].csv_key == name) found = i;
+        }
+        if (found == FIELD_UNKNOWN) {
+            cerr << "[ERROR] Unknown column: " << name << endl;
+            return false;
+        }
+        columns.push_back((Field)found);
+    }
+    return true;
+}
+
+bool compile_job_filter(Job &job, const std::string &filter, const std::string &label) {
+    std::string error;
+    if (!job.filter.compile(filter, error)) {
+        cerr << "[ERROR] Invalid " << label << ": " << error << endl;
+        return false;
+    }
+    return true;
+}
+
+// opening tree / players menulis agregat, bukan row game yang bisa disampel;
+// store selalu menyimpan semua game yang lolos dengan semua kolomnya
+bool check_job_format(const Job &job) {
+    if ((job.tree() || job.players() || job.store()) && job.sampled()) {
+        cerr << "[ERROR] Job " << job.name << ": format " << job.format << " cannot be combined with sample" << endl;
+        return false;
+    }
+    return true;
+}
+
+// kolom job dari --columns / columns; job store memakai kolom header dan
+// replay, job npy hanya kolom label dan moves_uci
+bool set_job_columns(Job &job, const std::string &columns) {
+    if (!job.store() && !job.npy()) return parse_columns(columns, job.columns);
+    if (!columns.empty()) {
+        cerr << "[ERROR] Job " << job.name << ": format " << job.format << " cannot be combined with columns" << endl;
+        return false;
+    }
+    if (job.npy()) return parse_columns("white_elo,black_elo,result,time_control,moves_uci,replay_error", job.columns);
+    return parse_columns("default,replay", job.columns);
+}
+
+// Manifest: satu section [nama] per job, baris "key = value", # komentar
+//
+//   [rapid_2000]
+//   filter  = WhiteElo >= 2000 && BlackElo >= 2000 && base in [600,1800]
+//   output  = data/cpp_lichess_rapid_elo2000_100k.csv   (relatif ke BASE_PATH)
+//   limit   = 100000
+//   columns = event,link,white_elo,black_elo,moves      (opsional, lihat parse_columns)
+//   format  = csv                                       (opsional, csv | arrow | tree | players | store | npy)
+//   sample  = reservoir                                 (opsional, lihat SampleMode)
+//   seed    = 7                                         (opsional)
+//   plies   = 12                                        (format tree: ply per game)
+//   memory  = 1024                                      (format tree / players: budget MB)
+//   max_plies  = 256                                    (format npy: token per game)
+//   shard_rows = 65536                                  (format npy: row per shard)
+bool load_manifest(const fs::path &path, std::vector<Job> &jobs) {
+    std::ifstream in(path);
+    if (!in) {
+        cerr << "[ERROR] Cannot open manifest: " << path << endl;
+        return false;
+    }
+
+    struct Section {
+        Job job;
+        std::string filter = DEFAULT_FILTER;
+        std::string columns;
+        bool has_output = false;
+    };
+    std::vector<Section> sections;
+
+    std::string line;
+    int line_no = 0;
+    while (std::getline(in, line)) {
+        line_no++;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        std::string_view text = line;
+        text.remove_prefix(std::min(text.find_first_not_of(" \t"), text.size()));
+        if (text.empty() || text[0] == '#') continue;
+
+        if (text[0] == '[') {
+            size_t close = text.find(']');
+            if (close == std::string_view::npos || close == 1) {
+                cerr << "[ERROR] Manifest line " << line_no << ": invalid section" << endl;
+                return false;
+            }
+            sections.emplace_back();
+            sections.back().job.name = std::string(text.substr(1, close - 1));
+            continue;
+        }
+
+        size_t eq = text.find('=');
+        if (eq == std::string_view::npos || sections.empty()) {
+            cerr << "[ERROR] Manifest line " << line_no << ": expected key = value inside a [job] section" << endl;
+            return false;
+        }
+        std::string_view key = text.substr(0, eq);
+        key = key.substr(0, key.find_last_not_of(" \t") + 1);
+        std::string_view value = text.substr(eq + 1);
+        value.remove_prefix(std::min(value.find_first_not_of(" \t"), value.size()));
+        value = value.substr(0, value.find_last_not_of(" \t") + 1);
+
+        Section &section = sections.back();
+        if (key == "filter") {
+            section.filter = std::string(value);
+        } else if (key == "output") {
+            section.job.output = BASE_PATH / fs::path(std::string(value));
+            section.has_output = true;
+        } else if (key == "limit") {
+            int limit;
+            if (!parse_int(value, 0, value.size(), limit) || limit < 1) {
+                cerr << "[ERROR] Manifest line " << line_no << ": invalid limit " << value << endl;
+                return false;
+            }
+            section.job.limit = limit;
+        } else if (key == "columns") {
+            section.columns = std::string(value);
+        } else if (key == "format") {
+            if (value != "csv" && value != "arrow" && value != "tree" && value != "players" && value != "store" &&
+                value != "npy") {
+                cerr << "[ERROR] Manifest line " << line_no << ": invalid format " << value << " (csv, arrow, tree, players, store or npy)" << endl;
+                return false;
+            }
+            section.job.format = std::string(value);
+        } else if (key == "sample") {
+            if (!parse_sample_mode(value, section.job.sample)) {
+                cerr << "[ERROR] Manifest line " << line_no << ": invalid sample " << value << endl;
+                return false;
+            }
+        } else if (key == "seed") {
+            int seed;
+            if (!parse_int(value, 0, value.size(), seed) || seed < 0) {
+                cerr << "[ERROR] Manifest line " << line_no << ": invalid seed " << value << endl;
+                return false;
+            }
+            section.job.seed = seed;
+        } else if (key == "plies") {
+            int plies;
+            if (!parse_int(value, 0, value.size(), plies) || plies < 0 || plies > 255) {
+                cerr << "[ERROR] Manifest line " << line_no << ": invalid plies " << value << " (0-255)" << endl;
+                return false;
+            }
+            section.job.tree_plies = plies;
+        } else if (key == "memory") {
+            int memory;
+            if (!parse_int(value, 0, value.size(), memory) || memory < 1) {
+                cerr << "[ERROR] Manifest line " << line_no << ": invalid memory " << value << " (MB)" << endl;
+                return false;
+            }
+            section.job.tree_memory_mb = memory;
+            section.job.player_memory_mb = memory;
+        } else if (key == "max_plies") {
+            int plies;
+            if (!parse_int(value, 0, value.size(), plies) || plies < 1 || plies > 4096) {
+                cerr << "[ERROR] Manifest line " << line_no << ": invalid max_plies " << value << " (1-4096)" << endl;
+                return false;
+            }
+            section.job.npy_plies = plies;
+        } else if (key == "shard_rows") {
+            int rows;
+            if (!parse_int(value, 0, value.size(), rows) || rows < 1) {
+                cerr << "[ERROR] Manifest line " << line_no << ": invalid shard_rows " << value << endl;
+                return false;
+            }
+            section.job.shard_rows = rows;
+        } else {
+            cerr << "[ERROR] Manifest line " << line_no << ": unknown key " << key << endl;
+            return false;
+        }
+    }
+
+    if (sections.empty() || sections.size() > MAX_JOBS) {
+        cerr << "[ERROR] Manifest needs 1 to " << MAX_JOBS << " jobs" << endl;
+        return false;
+    }
+
+    jobs.clear();
+    jobs.reserve(sections.size());
+    for (auto &section : sections) {
+        Job &job = section.job;
+        if (!section.has_output) {
+            cerr << "[ERROR] Job " << job.name << " has no output" << endl;
+            return false;
+        }
+        if (job.format == "arrow") job.output.replace_extension(".arrow");
+        if (job.store()) job.output.replace_extension(".store");
+        if (job.npy()) job.output.replace_extension(".npy");
+        if (!check_job_format(job) || !compile_job_filter(job, section.filter, "filter for job " + job.name) ||
+            !set_job_columns(job, section.columns)) {
+            return false;
+        }
+        for (const auto &other : jobs) {
+            if (other.output == job.output) {
+                cerr << "[ERROR] Jobs " << other.name << " and " << job.name << " write the same file" << endl;
+                return false;
+            }
+        }
+        jobs.push_back(std::move(job));
+    }
+    return true;
+}
+
+// Job dari --manifest, atau satu job dari --filter / --output / --format / --limit / --columns
+bool load_jobs(const Options &options, std::vector<Job> &jobs) {
+    if (!options.manifest.empty()) return load_manifest(options.manifest, jobs);
+
+    Job job;
+    job.name = options.output.stem().string();
+    job.output = options.output;
+    job.format = options.format;
+    job.limit = options.limit;
+    job.sample = options.sample;
+    job.seed = options.seed;
+    job.tree_plies = options.tree_plies;
+    job.tree_memory_mb = options.tree_memory_mb;
+    job.player_memory_mb = options.player_memory_mb;
+    job.npy_plies = options.npy_plies;
+    job.shard_rows = options.shard_rows;
+    if (job.format == "arrow") job.output.replace_extension(".arrow");
+    if (job.store()) job.output.replace_extension(".store");
+    if (job.npy()) job.output.replace_extension(".npy");
+    if (!check_job_format(job) || !compile_job_filter(job, options.filter, "--filter") ||
+        !set_job_columns(job, options.columns)) {
+        return false;
+    }
+
+    jobs.clear();
+    jobs.push_back(std::move(job));
+    return true;
+}
+
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parse_args(argc, argv, options) || !load_jobs(options, JOBS)) {
+        return 1;
+    }
+
+    // path turunan mengikuti --input / --output / --manifest
+    SOURCE_PATH = options.input;
+    OUTPUT_PATH = options.output;
+    FILE_NAME = OUTPUT_PATH.filename();
+    CHECKPOINT_PATH = fs::path(OUTPUT_PATH).replace_extension(".checkpoint");
+    if (!options.manifest.empty()) {
+        FILE_NAME = options.manifest.filename();
+        CHECKPOINT_PATH = fs::path(options.manifest).replace_extension(".checkpoint");
+    }
+    FRAME_INDEX_PATH = SOURCE_PATH.string() + ".frames";
+
+    for (const auto &job : JOBS) {
+        if (options.resume && job.format != "csv") {
+            cerr << "[ERROR] --resume only works with --format csv" << endl;
+            return 1;
+        }
+        if (options.resume && job.sampled()) {
+            cerr << "[ERROR] --resume does not work with sampling, the reservoir is not checkpointed" << endl;
+            return 1;
+        }
+    }
+
+    prevent_sleep();
+
+    Logger logger(options.log);
+    logger.info("======================================");
+    logger.info("Starting PGN parsing...", true);
+    logger.info("Threads         : " + std::to_string(options.threads), true);
+    logger.info("Scanner         : " + std::string(pgn_scan::active_kernel().name), true);
+    if (JOBS.size() == 1) {
+        logger.info("Filter          : " + JOBS[0].filter.source, true);
+        if (JOBS[0].sampled()) {
+            logger.info("Sample          : " + std::string(sample_mode_name(JOBS[0].sample)) + ", "
+                        + std::to_string(JOBS[0].limit) + " rows, seed " + std::to_string(JOBS[0].seed), true);
+        }
+        if (JOBS[0].tree()) {
+            logger.info("Opening tree    : " + std::to_string(JOBS[0].tree_plies) + " plies, "
+                        + std::to_string(JOBS[0].tree_memory_mb) + " MB", true);
+        }
+        if (JOBS[0].players()) {
+            logger.info("Players         : " + std::to_string(JOBS[0].player_memory_mb) + " MB", true);
+        }
+        if (JOBS[0].store()) logger.info("Output          : " + JOBS[0].output.string(), true);
+        if (JOBS[0].npy()) {
+            logger.info("NPY shards      : " + std::to_string(JOBS[0].npy_plies) + " plies, "
+                        + std::to_string(JOBS[0].shard_rows) + " rows per shard, vocabulary "
+                        + std::to_string(NPY_VOCAB_SIZE) + " tokens", true);
+        }
+    } else {
+        logger.info("Manifest        : " + options.manifest.string() + " (" + std::to_string(JOBS.size()) + " jobs)", true);
+        for (const auto &job : JOBS) {
+            std::string mode = job.tree()
+                ? "opening tree, " + std::to_string(job.tree_plies) + " plies, " + std::to_string(job.tree_memory_mb) + " MB"
+                : job.players() ? "players, " + std::to_string(job.player_memory_mb) + " MB"
+                : job.store() ? std::string("game store, all matching games")
+                : "limit " + std::to_string(job.limit)
+                  + (job.sampled() ? ", sample " + std::string(sample_mode_name(job.sample)) : "")
+                  + (job.npy() ? ", npy " + std::to_string(job.npy_plies) + " plies" : "");
+            logger.info("Job             : " + job.name + " | " + job.filter.source + " -> " + job.output.string()
+                        + " (" + mode + ")", true);
+        }
+    }
+    auto start_time = std::chrono::steady_clock::now();
+    
+    const fs::path file_path = SOURCE_PATH;
+
+    // Input: file atau "-" (stdin). zstd dikenali dari magic byte, selain itu
+    // dianggap PGN biasa: file di-mmap, stdin dibaca per blok besar.
+    const bool from_stdin = file_path == "-";
+    ifstream fin;
+    if (from_stdin) {
+#ifdef _WIN32
+        _setmode(_fileno(stdin), _O_BINARY);
+#endif
+    } else {
+        fin.open(file_path, ios::binary);
+        if (!fin) {
+            cerr << "[ERROR] Cannot open file: " << file_path << endl;
+            return 1;
+        }
+    }
+    std::istream &source = from_stdin ? std::cin : fin;
+
+    char magic[4];
+    source.read(magic, sizeof(magic));
+    std::string_view prefix(magic, source.gcount());
+    const bool compressed = is_zstd_magic(magic, prefix.size());
+    if (!from_stdin) {
+        source.clear();
+        prefix = {};
+    }
+    if (from_stdin && options.resume) {
+        cerr << "[ERROR] --resume needs a file input, stdin cannot be read again" << endl;
+        return 1;
+    }
+
+    // mapping harus hidup sampai semua batch selesai ditulis
+    MappedFile mapped;
+    if (!from_stdin && !compressed) {
+        std::string error;
+        if (!mapped.open(file_path, error, true)) {
+            cerr << "[ERROR] Cannot map input: " << error << endl;
+            return 1;
+        }
+    }
+    const uintmax_t source_size = from_stdin ? 0 : fs::file_size(file_path);
+    logger.info(std::string("Input           : ") + (from_stdin ? "stdin, " : "") +
+                (compressed ? "zstd" : from_stdin ? "PGN" : "PGN (mmap)"), true);
+
+    Checkpoint checkpoint;
+    if (options.resume) {
+        if (!checkpoint.load(CHECKPOINT_PATH)) {
+            cerr << "[ERROR] Cannot read checkpoint: " << CHECKPOINT_PATH << endl;
+            return 1;
+        }
+        if (checkpoint.source_size != source_size) {
+            cerr << "[ERROR] Checkpoint was made for a different source file" << endl;
+            return 1;
+        }
+        if ((checkpoint.jobs_hash != 0 && checkpoint.jobs_hash != jobs_hash(JOBS)) ||
+            checkpoint.jobs.size() != JOBS.size()) {
+            cerr << "[ERROR] Checkpoint was made with a different --filter or manifest" << endl;
+            return 1;
+        }
+
+        logger.info("Resuming at     : " + std::to_string(checkpoint.scanned) + " scanned, "
+                    + std::to_string(checkpoint.collected) + " collected", true);
+    }
+
+    OrderedWriter writer(start_time);
+    for (size_t j = 0; j < JOBS.size(); ++j) {
+        const Job &job = JOBS[j];
+        writer.add_job(job, options.resume ? checkpoint.jobs[j].csv_bytes : 0, options.direct_io);
+
+        const JobOutput &output = writer.outputs.back();
+        if (output.arrow && JOBS.size() == 1) {
+            logger.info("Output          : " + job.output.string(), true);
+        }
+        if (output.csv && options.direct_io && !output.csv->direct_io()) {
+            logger.info("O_DIRECT not available for " + job.output.string() + ", using buffered writes", true);
+        }
+    }
+    writer.logger = &logger;
+    writer.source_size = source_size;
+    if (options.resume) writer.resume_from(checkpoint);
+
+    // Pipeline: thread ini dekompres dan memotong batch, worker parse + filter,
+    // writer menulis hasil sesuai urutan batch
+    const bool threaded = options.threads > 1;
+    const size_t max_in_flight = options.threads * 2 + 2;
+
+    BlockingQueue<GameBatch> work_queue(max_in_flight);
+    BlockingQueue<BatchResult> result_queue(max_in_flight);
+    std::atomic<bool> stop{false};
+
+    // batasi jumlah batch yang sedang diproses supaya memori tidak terus naik
+    std::mutex in_flight_mutex;
+    std::condition_variable in_flight_cv;
+    size_t in_flight = 0;
+
+    std::vector<std::thread> workers;
+    std::thread writer_thread;
+
+    ResultPool result_pool(threaded ? options.threads : 1u);
+    writer.results = &result_pool;
+
+    // state filter + reservoir per worker, tetap hidup sampai sampel digabung
+    std::vector<std::unique_ptr<JobFilters>> worker_filters;
+    for (unsigned t = 0; t < (threaded ? options.threads : 1u); ++t) {
+        worker_filters.push_back(std::make_unique<JobFilters>(JOBS, writer.finished, threaded ? options.threads : 1u));
+    }
+
+    if (threaded) {
+        for (unsigned t = 0; t < options.threads; ++t) {
+            workers.emplace_back([&, t]() {
+                GameBatch batch;
+                MoveText move_text;
+                Replay replay;
+                JobFilters &filters = *worker_filters[t];
+                while (work_queue.pop(batch)) {
+                    BatchResult result = result_pool.acquire(t);
+                    process_batch(std::move(batch), result, move_text, replay, filters);
+                    if (!result_queue.push(std::move(result))) break;
+                }
+            });
+        }
+
+        writer_thread = std::thread([&]() {
+            BatchResult result;
+            while (result_queue.pop(result)) {
+                size_t written_before = writer.next_index;
+                bool more = writer.write(std::move(result));
+                {
+                    // batch baru dianggap selesai setelah ditulis sesuai urutan
+                    std::lock_guard<std::mutex> lock(in_flight_mutex);
+                    in_flight -= writer.next_index - written_before;
+                    if (!more) stop = true;
+                }
+                in_flight_cv.notify_one();
+            }
+        });
+    }
+
+    MoveText move_text;
+    Replay replay;
+    JobFilters &filters = *worker_filters[0];
+    size_t batch_index = 0;
+
+    auto dispatch = [&](GameBatch &&batch) {
+        batch.index = batch_index++;
+
+        if (!threaded) {
+            BatchResult result = result_pool.acquire(0);
+            process_batch(std::move(batch), result, move_text, replay, filters);
+            if (!writer.write(std::move(result))) stop = true;
+            return;
+        }
+
+        {
+            auto wait_start = std::chrono::steady_clock::now();
+            std::unique_lock<std::mutex> lock(in_flight_mutex);
+            in_flight_cv.wait(lock, [&] { return stop || in_flight < max_in_flight; });
+            pipeline_stats.reader_wait_ns += lap_ns(wait_start);
+            if (stop) return;
+            in_flight++;
+        }
+        work_queue.push(std::move(batch));
+    };
+
+    // Dump dengan banyak frame zstd didekompres paralel per range frame,
+    // selain itu streaming satu thread. Decode dimulai dari awal frame zstd
+    // yang dicatat checkpoint saat resume.
+    FrameIndex frame_index;
+    bool parallel_frames = false;
+    if (threaded && compressed && !from_stdin) {
+        if (!frame_index.load(FRAME_INDEX_PATH, source_size)) {
+            logger.info("Building frame index: " + FRAME_INDEX_PATH.string(), true);
+            if (build_frame_index(file_path, frame_index)) {
+                frame_index.save(FRAME_INDEX_PATH);
+            } else {
+                logger.info("Frame index failed, using streaming decompression", true);
+                frame_index.frames.clear();
+            }
+        }
+        parallel_frames = frame_index.frame_count() > 1;
+        logger.info("ZSTD frames     : " + std::to_string(frame_index.frame_count()), true);
+    }
+
+    bool failed = false;
+    if (!compressed && from_stdin) {
+        failed = !read_plain_stream(source, prefix, dispatch, stop);
+    } else if (!compressed) {
+        split_mapped(std::string_view(mapped.data(), mapped.size()), checkpoint.position, dispatch, stop);
+    } else if (parallel_frames) {
+        failed = !decompress_frames(file_path, frame_index, checkpoint.position, options.threads, dispatch, stop);
+    } else {
+        if (!from_stdin) source.seekg(checkpoint.position.compressed_offset);
+        failed = !decompress_stream(source, checkpoint.position, prefix, dispatch, stop);
+    }
+
+    if (threaded) {
+        work_queue.close();
+        for (auto &worker : workers) worker.join();
+        result_queue.close();
+        writer_thread.join();
+    }
+
+    if (!failed) {
+        // sampel, opening tree dan tabel pemain digabung dari semua worker
+        std::vector<JobFilters *> deferred;
+        for (auto &worker : worker_filters) deferred.push_back(worker.get());
+        writer.write_samples(deferred);
+        writer.write_trees(deferred);
+        writer.write_players(deferred);
+    }
+    writer.finish();
+
+    if (failed) {
+        logger.info("Run failed, resume with --resume", true);
+        return 1;
+    }
+
+    // run selesai, checkpoint tidak diperlukan lagi
+    fs::remove(CHECKPOINT_PATH);
+
+    size_t scanned_games = writer.scanned_games;
+    size_t collected_games = writer.collected_games;
+
+    // logging
+    auto end_time = std::chrono::steady_clock::now();
+    auto total_sec =
+        std::chrono::duration_cast<std::chrono::seconds>(end_time - start_time).count();
+
+    logger.info("Run finished    : " + FILE_NAME.string(), true);
+    logger.info("Total scanned   : " + std::to_string(scanned_games), true);
+    logger.info("Total collected : " + std::to_string(collected_games), true);
+    if (JOBS.size() > 1) {
+        for (const auto &output : writer.outputs) {
+            logger.info("Job collected   : " + output.job->name + " | " + std::to_string(output.collected) + " rows -> "
+                        + output.job->output.string(), true);
+        }
+    }
     logger.info("Total time      : " + std::to_string(total_sec) + " seconds", true);
-    logger.info("Summary         : " + log_progress(scanned_games, collected_games, TOTAL_GAMES, start_time), true);
+    logger.stats(stats_json("final", scanned_games, collected_games, start_time, writer.resumed_scanned));
+    logger.info("Summary         : " + log_progress(scanned_games, collected_games, TOTAL_GAMES, start_time,
+                                                    writer.resumed_scanned), true);
     logger.info("======================================\n");
 
     return 0;
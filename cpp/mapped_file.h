@@ -0,0 +1,101 @@
+#pragma once
+
+// File read-only lewat mmap (Windows: MapViewOfFile). Dipakai game store dan
+// input .pgn tanpa kompresi di generate_data: teks dibaca langsung dari page
+// cache, tanpa salinan read() ke buffer sendiri.
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    ~MappedFile() {
+        close();
+    }
+
+    // sequential: kernel diberi tahu file dibaca sekali dari depan
+    // (readahead lebih agresif, page yang lewat boleh dibuang)
+    bool open(const std::filesystem::path &path, std::string &error, bool sequential = false) {
+        close();
+#ifdef _WIN32
+        file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                           sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return fail("cannot open " + path.string(), error);
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) return fail("cannot read " + path.string(), error);
+        bytes = (size_t)file_size.QuadPart;
+        mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) return fail("cannot map " + path.string(), error);
+        view = (const char *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!view) return fail("cannot map " + path.string(), error);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return fail("cannot open " + path.string(), error);
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            ::close(fd);
+            return fail("cannot read " + path.string(), error);
+        }
+        bytes = (size_t)st.st_size;
+        void *mapped = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);  // mapping tetap valid setelah fd ditutup
+        if (mapped == MAP_FAILED) return fail("cannot map " + path.string(), error);
+        view = (const char *)mapped;
+        if (sequential) madvise(mapped, bytes, MADV_SEQUENTIAL);
+#endif
+        return true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (view) UnmapViewOfFile(view);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (view) munmap((void *)view, bytes);
+#endif
+        view = nullptr;
+        bytes = 0;
+    }
+
+    const char *data() const {
+        return view;
+    }
+
+    size_t size() const {
+        return bytes;
+    }
+
+private:
+    const char *view = nullptr;
+    size_t bytes = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+
+    bool fail(const std::string &message, std::string &error) {
+        error = message;
+        close();
+        return false;
+    }
+};
@@ -0,0 +1,282 @@
+#pragma once
+
+// Cleaning movetext PGN tanpa regex: clean_moves mengubah raw game jadi SAN
+// dipisah spasi plus jumlah langkah putih / hitam, dan (opsional) membaca
+// anotasi Lichess [%clk] / [%eval] dari komentar. Hasilnya identik dengan
+// rantai std::regex_replace lama, lihat check_clean_moves.cpp.
+
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+static const int NO_ANNOTATION = INT_MIN;  // ply tanpa [%clk] / [%eval]
+static const int MATE_CP = 100000;         // "#n" -> MATE_CP - n, "#-n" -> -(MATE_CP - n)
+static const int MAX_EVAL_CP = 50000;      // eval biasa dibatasi supaya tidak bentrok dengan mate
+
+// "h:mm:ss" / "m:ss" / "h:mm:ss.f" -> centidetik
+inline bool parse_clock(const char *&p, const char *end, int &cs) {
+    int64_t total = 0;
+    for (int part = 0; part < 3; ++part) {
+        if (p == end || !std::isdigit((unsigned char)*p)) return false;
+        int64_t value = 0;
+        while (p < end && std::isdigit((unsigned char)*p)) value = std::min<int64_t>(value * 10 + (*p++ - '0'), 1000000);
+        total = total * 60 + value;
+        if (p == end || *p != ':') break;
+        p++;
+    }
+    total *= 100;
+    if (p < end && *p == '.') {
+        p++;
+        for (int scale = 10; p < end && std::isdigit((unsigned char)*p); scale /= 10) total += (*p++ - '0') * scale;
+    }
+    cs = (int)std::min<int64_t>(total, INT_MAX);
+    return true;
+}
+
+// "0.17" / "-1.5" / "#3" / "#-2" (boleh diikuti ",depth") -> centipawn dari sisi putih
+inline bool parse_eval(const char *&p, const char *end, int &cp) {
+    bool mate = p < end && *p == '#';
+    if (mate) p++;
+    bool negative = p < end && *p == '-';
+    if (p < end && (*p == '-' || *p == '+')) p++;
+    if (p == end || !std::isdigit((unsigned char)*p)) return false;
+
+    int64_t whole = 0;
+    while (p < end && std::isdigit((unsigned char)*p)) whole = std::min<int64_t>(whole * 10 + (*p++ - '0'), MATE_CP);
+    int64_t value = mate ? MATE_CP - std::min<int64_t>(whole, MATE_CP - 1 - MAX_EVAL_CP) : whole * 100;
+    if (!mate && p < end && *p == '.') {
+        p++;
+        for (int scale = 10; p < end && std::isdigit((unsigned char)*p); scale /= 10) value += (*p++ - '0') * scale;
+    }
+    if (!mate) value = std::min<int64_t>(value, MAX_EVAL_CP);
+    cp = (int)(negative ? -value : value);
+    return true;
+}
+
+// Anotasi Lichess per ply ("{ [%eval 0.17] [%clk 0:03:00] }"), dibaca oleh
+// MovetextCursor saat komentar dilewati, tanpa regex. Buffer dipakai ulang
+// antar game, tidak ada alokasi per langkah.
+struct Annotations {
+    std::vector<int> clocks;  // centidetik sisa setelah ply, index = ply - 1
+    std::vector<int> evals;   // centipawn, NO_ANNOTATION jika ply tidak punya nilai
+    int markers = 0;          // penanda langkah sejauh ini, diisi clean_moves
+    int last_ply = 0;         // ply anotasi terakhir
+    std::string text;         // buffer kolom array
+
+    void clear() {
+        clocks.clear();
+        evals.clear();
+        markers = 0;
+        last_ply = 0;
+    }
+
+    // komentar milik langkah sebelum komentar. "1. e4 {..} e5 {..}" tanpa
+    // "1..." tetap dua ply berbeda: ply tidak pernah mundur ke ply terakhir.
+    void add_comment(const char *p, const char *end) {
+        int clock = NO_ANNOTATION, eval = NO_ANNOTATION;
+        while ((p = (const char *)memchr(p, '%', end - p))) {
+            p++;
+            bool is_clock = end - p >= 4 && memcmp(p, "clk ", 4) == 0;
+            bool is_eval = end - p >= 5 && memcmp(p, "eval ", 5) == 0;
+            if (!is_clock && !is_eval) continue;
+            p += is_clock ? 4 : 5;
+            while (p < end && *p == ' ') p++;
+            int value;
+            if (is_clock && parse_clock(p, end, value)) clock = value;
+            if (is_eval && parse_eval(p, end, value)) eval = value;
+        }
+        if (clock == NO_ANNOTATION && eval == NO_ANNOTATION) return;
+
+        int ply = std::max(markers, last_ply + 1);
+        if ((int)clocks.size() < ply) {
+            clocks.resize(ply, NO_ANNOTATION);
+            evals.resize(ply, NO_ANNOTATION);
+        }
+        if (clock != NO_ANNOTATION) clocks[ply - 1] = clock;
+        if (eval != NO_ANNOTATION) evals[ply - 1] = eval;
+        last_ply = ply;
+    }
+};
+
+// Hasil cleaning movetext, dipakai ulang antar game supaya tidak alokasi lagi
+struct MoveText {
+    // format kolom moves lama: whitespace dibuang, hanya penanda langkah jadi
+    // spasi, jadi tanpa "1..." langkah hitam menempel ("1. e4 e5" -> "e4e5")
+    std::string moves;
+    std::string san;     // token SAN dipisah satu spasi (whitespace dan penanda), untuk replay
+    int white_moves = 0;
+    int black_moves = 0;
+    Annotations annotations;  // hanya diisi jika clean_moves diminta anotasi
+
+    void clear() {
+        moves.clear();
+        san.clear();
+        white_moves = 0;
+        black_moves = 0;
+        annotations.clear();
+    }
+};
+
+// Cursor di atas raw game yang hanya melihat movetext: baris "[..." dilewati,
+// komentar "{...}" dibuang (isinya diberikan ke annotations jika ada) dan
+// newline dianggap spasi.
+struct MovetextCursor {
+    const char *pos;
+    const char *end;
+    Annotations *annotations = nullptr;
+    bool line_start = true;
+
+    // lewati baris header dan komentar sampai karakter movetext berikutnya
+    void skip() {
+        while (pos < end) {
+            if (line_start && *pos == '[') {
+                const char *nl = (const char *)memchr(pos, '\n', end - pos);
+                pos = nl ? nl + 1 : end;
+                continue;
+            }
+            line_start = false;
+
+            if (*pos != '{') return;
+
+            // komentar tanpa penutup di baris yang sama tetap dianggap teks biasa
+            const char *close = pos + 1;
+            while (close < end && *close != '}' && *close != '\r') close++;
+            if (close == end || *close != '}') return;
+            if (annotations) annotations->add_comment(pos + 1, close);
+            pos = close + 1;
+        }
+    }
+
+    bool at_end() {
+        skip();
+        return pos >= end;
+    }
+
+    char peek() {
+        skip();
+        if (pos >= end) return '\0';
+        return *pos == '\n' ? ' ' : *pos;
+    }
+
+    char next() {
+        char c = peek();
+        if (pos < end) {
+            line_start = *pos == '\n';
+            pos++;
+        }
+        return c;
+    }
+};
+
+// Single-pass pengganti rantai regex lama, hasilnya identik:
+//   {komentar}        -> dibuang
+//   "12..."           -> langkah hitam, "12." -> langkah putih
+//   "!" / "?"         -> dibuang
+//   result di akhir   -> dibuang
+// Setiap penanda langkah jadi satu spasi, whitespace lain dibuang.
+// out.san berisi token yang sama tapi dipisah di setiap whitespace juga.
+// annotate: isi out.annotations dari [%clk] / [%eval] di komentar.
+inline void clean_moves(std::string_view movetext, MoveText &out, bool annotate = false) {
+    out.clear();
+    std::string &moves = out.moves;
+    std::string &san = out.san;
+
+    Annotations *annotations = annotate ? &out.annotations : nullptr;
+    MovetextCursor cur{ movetext.data(), movetext.data() + movetext.size(), annotations };
+
+    // jumlah karakter terakhir yang tersambung tanpa whitespace / "!?",
+    // untuk mengecek result yang menempel di akhir movetext
+    size_t tail_run = 0;
+    bool gap = false;
+    bool split = false;  // karakter san berikutnya mulai token baru
+
+    auto emit = [&](char c) {
+        if (gap) {
+            tail_run = 0;
+            gap = false;
+        }
+        moves += c;
+        tail_run++;
+        if (c == ' ') return;
+        if (split && !san.empty()) san += ' ';
+        split = false;
+        san += c;
+    };
+
+    auto emit_marker = [&](bool black) {
+        if (black) out.black_moves++;
+        else out.white_moves++;
+        if (annotations) annotations->markers++;
+        split = true;
+
+        // spasi di awal string dibuang
+        if (moves.empty()) {
+            gap = false;
+            tail_run = 0;
+            return;
+        }
+        emit(' ');
+    };
+
+    while (!cur.at_end()) {
+        char c = cur.next();
+
+        if (c >= '0' && c <= '9') {
+            size_t run_start = moves.size(), san_start = san.size();
+            size_t saved_run = tail_run;
+            bool saved_gap = gap, saved_split = split;
+
+            emit(c);
+            while (cur.peek() >= '0' && cur.peek() <= '9') emit(cur.next());
+            if (cur.peek() != '.') continue;
+
+            // nomor langkah: buang digit, ganti dengan penanda
+            moves.resize(run_start);
+            san.resize(san_start);
+            tail_run = saved_run;
+            gap = saved_gap;
+            split = saved_split;
+            cur.next();
+
+            // lookahead tidak membaca anotasi: komentar yang dilewatinya
+            // dibaca lagi oleh cur jika ternyata bukan "..."
+            MovetextCursor look = cur;
+            look.annotations = nullptr;
+            if (look.next() == '.' && look.next() == '.') {
+                cur.pos = look.pos;
+                cur.line_start = look.line_start;
+                emit_marker(true);
+            } else {
+                emit_marker(false);
+            }
+        } else if (c == '.' || c == ',') {
+            emit_marker(c == ',');
+        } else if (c == '!' || c == '?') {
+            tail_run = 0;
+            gap = false;
+        } else if (std::isspace((unsigned char)c)) {
+            gap = true;
+            split = true;
+        } else {
+            emit(c);
+        }
+    }
+
+    // buang result di akhir
+    for (const char *result : { "1-0", "0-1", "1/2-1/2" }) {
+        size_t len = strlen(result);
+        if (tail_run >= len && moves.size() >= len &&
+            moves.compare(moves.size() - len, len, result) == 0) {
+            moves.resize(moves.size() - len);
+            // karakter result tidak dipisah whitespace, jadi juga ada di ujung san
+            san.resize(san.size() - len);
+            if (!san.empty() && san.back() == ' ') san.pop_back();
+            break;
+        }
+    }
+}
@@ -0,0 +1,308 @@
+#pragma once
+
+// Export langkah untuk training model: tiap game jadi satu row token int16
+// (vocabulary UCI tetap, dibuat saat compile) dan satu row label, ditulis
+// sebagai shard .npy dengan jumlah row tetap. Tidak ada parsing di Python:
+//
+//   tokens = np.load("blitz_00000.tokens.npy", mmap_mode="r")  # (rows, plies) int16
+//   labels = np.load("blitz_00000.labels.npy", mmap_mode="r")  # labels["white_elo"], ...
+//
+// Token 0 = padding, 1..NPY_VOCAB_SIZE-1 = langkah UCI yang secara geometri
+// mungkin (garis ratu, lompatan kuda, promosi n/b/r/q), urut menurut
+// chess::Move::pack(). <stem>.vocab.txt berisi satu langkah per baris, baris
+// ke-i = token i. Game lebih panjang dari plies dipotong, label plies tetap
+// berisi jumlah langkah asli. Game yang replay-nya gagal tidak ditulis
+// sebagai row padding, hanya dihitung (skip / rows_skipped).
+//
+// Shard penuh ditulis oleh task terpisah (paling banyak NPY_WRITE_TASKS
+// sekaligus) selagi shard berikutnya diisi; buffer shard dipakai ulang.
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "chess_board.h"
+#include "pgn_filter.h"
+
+namespace fs = std::filesystem;
+
+static const int16_t NPY_MISSING = INT16_MIN;  // label tanpa nilai / bukan angka
+static const size_t NPY_WRITE_TASKS = 2;
+static const int NPY_CODES = 5 << 12;          // Move::pack() < 5 << 12
+
+// kolom labels.npy, semua '<i2'
+enum NpyLabel {
+    NPY_LABEL_RESULT,     // 1 putih menang, 0 remis, -1 hitam menang
+    NPY_LABEL_WHITE_ELO,
+    NPY_LABEL_BLACK_ELO,
+    NPY_LABEL_BASE,       // detik
+    NPY_LABEL_INCREMENT,  // detik
+    NPY_LABEL_PLIES,      // jumlah langkah sebelum dipotong
+    NPY_LABEL_TRUNCATED,  // 1 jika langkah lebih dari plies dan dipotong
+    NPY_LABEL_COUNT
+};
+
+static const char *const NPY_LABEL_NAMES[NPY_LABEL_COUNT] = {
+    "result", "white_elo", "black_elo", "base", "increment", "plies", "truncated"
+};
+
+struct NpyVocab {
+    std::array<int16_t, NPY_CODES> token{};  // Move::pack() -> token, 0 = tidak ada di vocabulary
+    std::array<uint16_t, 2048> code{};       // token -> Move::pack()
+    int size = 1;                            // termasuk token padding
+};
+
+constexpr bool npy_reachable(int from, int to, int promotion) {
+    int from_file = from % 8, from_rank = from / 8, to_file = to % 8, to_rank = to / 8;
+    int file_step = to_file > from_file ? to_file - from_file : from_file - to_file;
+    int rank_step = to_rank > from_rank ? to_rank - from_rank : from_rank - to_rank;
+    if (promotion) {
+        bool white = from_rank == 6 && to_rank == 7, black = from_rank == 1 && to_rank == 0;
+        return (white || black) && file_step <= 1 && promotion <= 4;
+    }
+    if (from == to) return false;
+    bool line = file_step == 0 || rank_step == 0 || file_step == rank_step;
+    bool knight = (file_step == 1 && rank_step == 2) || (file_step == 2 && rank_step == 1);
+    return line || knight;
+}
+
+constexpr NpyVocab build_npy_vocab() {
+    NpyVocab vocab;
+    for (int code = 0; code < NPY_CODES; ++code) {
+        if (!npy_reachable(code & 63, code >> 6 & 63, code >> 12)) continue;
+        vocab.token[code] = (int16_t)vocab.size;
+        vocab.code[vocab.size++] = (uint16_t)code;
+    }
+    return vocab;
+}
+
+static constexpr NpyVocab NPY_VOCAB = build_npy_vocab();
+static constexpr int NPY_VOCAB_SIZE = NPY_VOCAB.size;
+static_assert(NPY_VOCAB_SIZE == 1969, "1792 langkah ratu / kuda + 176 promosi + padding");
+
+class NpyWriter {
+public:
+    // nilai teks satu game, seperti di kolom CSV
+    struct Record {
+        std::string_view result;
+        std::string_view white_elo;
+        std::string_view black_elo;
+        std::string_view time_control;
+        std::string_view moves_uci;  // dipisah spasi
+    };
+
+    // path: <dir>/<stem>.npy, shard ditulis ke <dir>/<stem>_00000.tokens.npy dst.
+    NpyWriter(const fs::path &path, int plies, size_t shard_rows)
+        : prefix((path.parent_path() / path.stem()).string()), plies(plies), shard_rows(shard_rows) {
+        std::ofstream vocab(prefix + ".vocab.txt", std::ios::trunc);
+        if (!vocab) throw std::runtime_error("Cannot create npy vocabulary file");
+        vocab << "<pad>\n";
+        std::string uci;
+        for (int token = 1; token < NPY_VOCAB_SIZE; ++token) {
+            uci.clear();
+            chess::Board::append_uci(chess::Move::unpack(NPY_VOCAB.code[token]), uci);
+            vocab << uci << '\n';
+        }
+        if (!vocab) throw std::runtime_error("Cannot write npy vocabulary file");
+        start_shard();
+    }
+
+    NpyWriter(const NpyWriter &) = delete;
+    NpyWriter &operator=(const NpyWriter &) = delete;
+
+    ~NpyWriter() {
+        if (!closed) {
+            try {
+                close();
+            } catch (...) {
+            }
+        }
+    }
+
+    uint64_t rows_written() const {
+        return total_rows;
+    }
+
+    uint64_t rows_skipped() const {
+        return skipped_rows;
+    }
+
+    // game dengan replay error: tidak ada row, hanya dihitung
+    void skip() {
+        skipped_rows++;
+    }
+
+    size_t shards() const {
+        return submitted;
+    }
+
+    void append(const Record &game) {
+        int16_t *tokens = current.tokens.data() + current.rows * plies;
+        int16_t *labels = current.labels.data() + current.rows * NPY_LABEL_COUNT;
+
+        int count = 0;
+        std::string_view moves = game.moves_uci;
+        size_t pos = 0;
+        while (pos < moves.size()) {
+            size_t end = std::min(moves.find(' ', pos), moves.size());
+            int16_t token = uci_token(moves.substr(pos, end - pos));
+            pos = end + 1;
+            if (!token) continue;
+            if (count < plies) tokens[count] = token;
+            count++;
+        }
+        std::fill(tokens + std::min(count, plies), tokens + plies, (int16_t)0);
+
+        labels[NPY_LABEL_RESULT] = game.result == "1-0" ? 1 : game.result == "0-1" ? -1
+                           : game.result == "1/2-1/2" ? 0 : NPY_MISSING;
+        labels[NPY_LABEL_WHITE_ELO] = to_int16(game.white_elo, 0, game.white_elo.size());
+        labels[NPY_LABEL_BLACK_ELO] = to_int16(game.black_elo, 0, game.black_elo.size());
+        std::string_view tc = game.time_control;
+        size_t plus_sign = tc.find('+');
+        labels[NPY_LABEL_BASE] = labels[NPY_LABEL_INCREMENT] = NPY_MISSING;  // "-" (correspondence)
+        if (plus_sign != std::string_view::npos) {
+            labels[NPY_LABEL_BASE] = to_int16(tc, 0, plus_sign);
+            labels[NPY_LABEL_INCREMENT] = to_int16(tc, plus_sign + 1, tc.size());
+        }
+        labels[NPY_LABEL_PLIES] = (int16_t)std::min(count, (int)INT16_MAX);
+        labels[NPY_LABEL_TRUNCATED] = count > plies ? 1 : 0;
+
+        total_rows++;
+        if (++current.rows == shard_rows) {
+            submit();
+            start_shard();
+        }
+    }
+
+    // tulis shard terakhir (boleh kurang dari shard_rows) dan tunggu semua task
+    void close() {
+        if (closed) return;
+        closed = true;
+        if (current.rows > 0 || submitted == 0) submit();  // tanpa row tetap ada satu shard kosong
+        while (!writing.empty()) collect();
+    }
+
+private:
+    struct Shard {
+        size_t index = 0;
+        size_t rows = 0;
+        std::vector<int16_t> tokens;
+        std::vector<int16_t> labels;
+        bool failed = false;
+    };
+
+    std::string prefix;
+    int plies;
+    size_t shard_rows;
+    Shard current;
+    std::deque<std::future<Shard>> writing;
+    std::vector<Shard> spare;
+    size_t next_index = 0;
+    size_t submitted = 0;
+    uint64_t total_rows = 0;
+    uint64_t skipped_rows = 0;
+    bool closed = false;
+
+    static int16_t to_int16(std::string_view text, size_t begin, size_t end) {
+        int value;
+        if (!parse_int(text, begin, end, value) || value < INT16_MIN + 1 || value > INT16_MAX) return NPY_MISSING;
+        return (int16_t)value;
+    }
+
+    // "e7e8q" -> token, 0 jika bukan UCI
+    static int16_t uci_token(std::string_view uci) {
+        if (uci.size() < 4 || uci.size() > 5) return 0;
+        for (int i = 0; i < 4; ++i) {
+            char lo = i % 2 == 0 ? 'a' : '1';
+            if (uci[i] < lo || uci[i] > lo + 7) return 0;
+        }
+        int from = (uci[0] - 'a') + (uci[1] - '1') * 8, to = (uci[2] - 'a') + (uci[3] - '1') * 8;
+        int code = from | to << 6;
+        if (uci.size() == 5) {
+            size_t piece = std::string_view("pnbrqk").find(uci[4]);
+            if (piece == std::string_view::npos || piece == 0 || piece > 4) return 0;
+            code |= (int)piece << 12;
+        }
+        return NPY_VOCAB.token[code];
+    }
+
+    void start_shard() {
+        if (!spare.empty()) {
+            current = std::move(spare.back());
+            spare.pop_back();
+        } else {
+            current = Shard();
+            current.tokens.resize(shard_rows * plies);
+            current.labels.resize(shard_rows * NPY_LABEL_COUNT);
+        }
+        current.index = next_index++;
+        current.rows = 0;
+        current.failed = false;
+    }
+
+    void submit() {
+        if (writing.size() >= NPY_WRITE_TASKS) collect();
+        submitted++;
+        std::string path = shard_path(current.index);
+        int columns = plies;
+        writing.push_back(std::async(std::launch::async, [shard = std::move(current), path, columns]() mutable {
+            shard.failed = !write_shard(shard, path, columns);
+            return std::move(shard);
+        }));
+    }
+
+    void collect() {
+        Shard shard = writing.front().get();
+        writing.pop_front();
+        if (shard.failed) throw std::runtime_error("Cannot write npy shard " + shard_path(shard.index));
+        spare.push_back(std::move(shard));
+    }
+
+    std::string shard_path(size_t index) const {
+        char suffix[16];
+        snprintf(suffix, sizeof(suffix), "_%05zu", index);
+        return prefix + suffix;
+    }
+
+    // header .npy v1.0: magic, panjang header, dict Python rata 64 byte diakhiri '\n'
+    static std::string npy_header(const std::string &descr, size_t rows, int columns) {
+        std::string dict = "{'descr': " + descr + ", 'fortran_order': False, 'shape': (" + std::to_string(rows)
+                         + (columns ? ", " + std::to_string(columns) + ")" : std::string(",)")) + ", }";
+        size_t total = 10 + dict.size() + 1;
+        dict.append((64 - total % 64) % 64, ' ');
+        dict += '\n';
+        std::string header("\x93NUMPY\x01\x00", 8);
+        header += (char)(dict.size() & 0xFF);
+        header += (char)(dict.size() >> 8);
+        return header + dict;
+    }
+
+    static bool write_file(const std::string &path, const std::string &header, const int16_t *data, size_t count) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out.write(header.data(), header.size());
+        out.write((const char *)data, count * sizeof(int16_t));  // little endian
+        out.close();
+        return (bool)out;
+    }
+
+    static bool write_shard(const Shard &shard, const std::string &path, int columns) {
+        std::string descr = "[";
+        for (int i = 0; i < NPY_LABEL_COUNT; ++i) descr += "('" + std::string(NPY_LABEL_NAMES[i]) + "', '<i2'), ";
+        descr += "]";
+        return write_file(path + ".tokens.npy", npy_header("'<i2'", shard.rows, columns), shard.tokens.data(),
+                          shard.rows * columns) &&
+               write_file(path + ".labels.npy", npy_header(descr, shard.rows, 0), shard.labels.data(),
+                          shard.rows * NPY_LABEL_COUNT);
+    }
+};
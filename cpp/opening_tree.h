@@ -0,0 +1,172 @@
+#pragma once
+
+// Opening tree: posisi (hash Zobrist) -> menang putih / remis / menang hitam
+// dan rata-rata Elo, di tabel open addressing (linear probing) dengan batas
+// memori tetap. Satu tabel per worker, digabung di akhir scan.
+//
+// Jika tabel terisi 3/4, posisi dengan game paling sedikit dibuang sampai
+// minimal separuh slot kosong dan evicted_below naik: posisi dengan game
+// kurang dari evicted_below bisa kurang terhitung, posisi di atasnya hampir
+// pasti lengkap (hanya hilang game sebelum posisi itu cukup sering muncul).
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+struct TreeEntry {
+    uint64_t key = 0;       // 0 = slot kosong
+    uint64_t parent = 0;    // posisi sebelum move, 0 untuk root (lihat insert)
+    uint64_t elo_sum = 0;   // WhiteElo + BlackElo, hanya game dengan kedua Elo
+    uint32_t white = 0;
+    uint32_t draws = 0;
+    uint32_t black = 0;
+    uint32_t elo_games = 0;
+    uint16_t move = 0;      // chess::Move::pack() dari parent
+    uint8_t ply = 0;
+
+    uint64_t games() const {
+        return (uint64_t)white + draws + black;
+    }
+};
+
+enum class GameResult { WHITE, DRAW, BLACK };
+
+class OpeningTree {
+public:
+    int max_ply = 0;             // posisi sampai ply ini (0 = posisi awal)
+    uint32_t evicted_below = 0;  // 0: tidak pernah ada eviction
+    uint64_t evictions = 0;
+
+    OpeningTree(size_t memory_bytes, int max_ply) : max_ply(max_ply) {
+        size_t capacity = 1024;
+        while (capacity * 2 * sizeof(TreeEntry) <= memory_bytes) capacity *= 2;
+        table.resize(capacity);
+        mask = capacity - 1;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    const std::vector<TreeEntry> &slots() const {
+        return table;
+    }
+
+    const TreeEntry *find(uint64_t key) const {
+        key = key ? key : 1;
+        for (size_t i = key & mask;; i = (i + 1) & mask) {
+            if (table[i].key == key) return &table[i];
+            if (table[i].key == 0) return nullptr;
+        }
+    }
+
+    // satu game melewati posisi ini; elo_sum 0 jika Elo tidak diketahui
+    void add(uint64_t key, uint64_t parent, uint16_t move, int ply, GameResult result, int elo_sum) {
+        TreeEntry &entry = insert(key, parent, move, ply);
+        if (result == GameResult::WHITE) entry.white++;
+        else if (result == GameResult::DRAW) entry.draws++;
+        else entry.black++;
+        if (elo_sum > 0) {
+            entry.elo_sum += elo_sum;
+            entry.elo_games++;
+        }
+    }
+
+    // gabungkan tabel worker lain (jumlahnya ditambahkan)
+    void merge(const OpeningTree &other) {
+        evicted_below = std::max(evicted_below, other.evicted_below);
+        evictions += other.evictions;
+        for (const TreeEntry &from : other.table) {
+            if (!from.key) continue;
+            TreeEntry &entry = insert(from.key, from.parent, from.move, from.ply);
+            entry.white += from.white;
+            entry.draws += from.draws;
+            entry.black += from.black;
+            entry.elo_sum += from.elo_sum;
+            entry.elo_games += from.elo_games;
+        }
+    }
+
+    void release() {
+        std::vector<TreeEntry>().swap(table);
+        count = 0;
+        mask = 0;
+    }
+
+private:
+    std::vector<TreeEntry> table;
+    size_t mask = 0;
+    size_t count = 0;
+
+    TreeEntry &insert(uint64_t key, uint64_t parent, uint16_t move, int ply) {
+        key = key ? key : 1;
+        size_t i = key & mask;
+        for (; table[i].key; i = (i + 1) & mask) {
+            if (table[i].key != key) continue;
+
+            // transposisi: simpan jalur (ply, parent, move) terkecil supaya
+            // hasilnya tidak tergantung urutan game antar worker
+            TreeEntry &entry = table[i];
+            if (std::tie(ply, parent, move) < std::tie(entry.ply, entry.parent, entry.move)) {
+                entry.parent = parent;
+                entry.move = move;
+                entry.ply = (uint8_t)ply;
+            }
+            return entry;
+        }
+
+        if ((count + 1) * 4 > table.size() * 3) {
+            evict();
+            return insert(key, parent, move, ply);
+        }
+
+        TreeEntry &entry = table[i];
+        entry = TreeEntry();
+        entry.key = key;
+        entry.parent = parent;
+        entry.move = move;
+        entry.ply = (uint8_t)ply;
+        count++;
+        return entry;
+    }
+
+    // buang entry dengan games < 2^b, b terkecil yang membuang minimal separuh
+    void evict() {
+        size_t histogram[64] = {};
+        for (const TreeEntry &entry : table) {
+            if (!entry.key) continue;
+            int bucket = 0;
+            while (bucket < 63 && (entry.games() >> (bucket + 1))) bucket++;
+            histogram[bucket]++;
+        }
+        int bits = 0;
+        size_t removed = 0;
+        while (bits < 63 && removed * 2 < count) removed += histogram[bits++];
+        uint64_t threshold = uint64_t(1) << bits;
+
+        for (TreeEntry &entry : table) {
+            if (entry.key && entry.games() < threshold) {
+                entry.key = 0;
+                count--;
+                evictions++;
+            }
+        }
+        evicted_below = std::max<uint64_t>(evicted_below, std::min<uint64_t>(threshold, UINT32_MAX));
+
+        // rehash di tempat: mulai setelah slot kosong, setiap entry dipindah
+        // ke slot kosong pertama dari posisi home-nya
+        size_t start = 0;
+        while (table[start].key) start++;
+        for (size_t n = 1; n <= mask; ++n) {
+            size_t i = (start + n) & mask;
+            if (!table[i].key) continue;
+            TreeEntry entry = table[i];
+            table[i].key = 0;
+            size_t j = entry.key & mask;
+            while (table[j].key) j = (j + 1) & mask;
+            table[j] = entry;
+        }
+    }
+};
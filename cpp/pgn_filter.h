@@ -0,0 +1,695 @@
+#pragma once
+
+// Filter game dari ekspresi di command line, dicek per baris header:
+//
+//   WhiteElo>=2200 && BlackElo>=2200 && base in [180,300] && ECO ~ B2*
+//
+// Field : nama tag PGN apa saja (WhiteElo, ECO, Termination, WhiteTitle, ...)
+//         plus base / increment dari TimeControl ("180+2").
+// Operator: == != < <= > >= (angka), == != (string), ~ glob (* dan ?),
+//         in [lo,hi] (range angka inklusif), in {a, b, "c d"} (set),
+//         && || ! dan kurung.
+// Tag yang tidak ada, atau angka yang tidak valid, membuat perbandingan false.
+//
+// Ekspresi dikompilasi sekali menjadi program postfix datar per konjungsi
+// top-level (operand && paling luar). Hanya tag yang dipakai yang diekstrak,
+// dan setiap konjungsi dicek begitu semua tag-nya terbaca; urutannya diatur
+// ulang per worker menurut rasio tolak / cost yang teramati.
+
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// versi ringan std::stoi: tanpa alokasi substr dan tanpa exception
+inline bool parse_int(std::string_view s, size_t begin, size_t end, int &out) {
+    while (begin < end && std::isspace((unsigned char)s[begin])) begin++;
+
+    bool negative = false;
+    if (begin < end && (s[begin] == '+' || s[begin] == '-')) {
+        negative = s[begin] == '-';
+        begin++;
+    }
+
+    long value = 0;
+    size_t digits = 0;
+    while (begin < end && s[begin] >= '0' && s[begin] <= '9') {
+        value = value * 10 + (s[begin] - '0');
+        if (value > INT_MAX) return false;
+        begin++;
+        digits++;
+    }
+    if (digits == 0) return false;
+
+    out = negative ? -(int)value : (int)value;
+    return true;
+}
+
+// glob dengan * dan ?, tanpa alokasi
+inline bool glob_match(std::string_view pattern, std::string_view text) {
+    size_t p = 0, t = 0;
+    size_t star = std::string_view::npos, star_text = 0;
+    while (t < text.size()) {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == text[t])) {
+            p++;
+            t++;
+        } else if (p < pattern.size() && pattern[p] == '*') {
+            star = p++;
+            star_text = t;
+        } else if (star != std::string_view::npos) {
+            p = star + 1;
+            t = ++star_text;
+        } else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*') p++;
+    return p == pattern.size();
+}
+
+enum class FilterOp : uint8_t {
+    INT_CMP,    // field <cmp> a
+    INT_RANGE,  // a <= field <= b
+    INT_IN,     // field salah satu ints[a .. a+b)
+    STR_EQ,     // field == strings[a] (cmp EQ / NE)
+    STR_IN,     // field salah satu strings[a .. a+b)
+    GLOB,       // field ~ strings[a]
+    AND,
+    OR,
+    NOT,
+};
+
+enum class FilterCmp : uint8_t { EQ, NE, LT, LE, GT, GE };
+
+struct FilterInstr {
+    FilterOp op = FilterOp::AND;
+    FilterCmp cmp = FilterCmp::EQ;
+    uint8_t field = 0;
+    int a = 0;
+    int b = 0;
+};
+
+// Sumber nilai field: isi tag langsung, atau bagian dari TimeControl
+enum class FieldSource : uint8_t { TAG, TC_BASE, TC_INCREMENT };
+
+struct FilterField {
+    std::string name;  // nama di ekspresi
+    uint8_t tag = 0;   // index di FilterProgram::tags
+    FieldSource source = FieldSource::TAG;
+};
+
+struct FilterConjunct {
+    uint32_t begin = 0;  // range instruksi di code
+    uint32_t end = 0;
+    uint64_t field_mask = 0;
+    int cost = 0;
+};
+
+struct FilterProgram {
+    static const size_t MAX_FIELDS = 64;
+    static const size_t MAX_CONJUNCTS = 64;
+    static const size_t MAX_STACK = 64;  // stack eval_conjunct: satu uint64_t
+
+    std::string source;
+    std::vector<std::string> tags;  // tag unik yang perlu diekstrak
+    std::vector<FilterField> fields;
+    std::vector<FilterInstr> code;
+    std::vector<FilterConjunct> conjuncts;
+    std::vector<std::string> strings;
+    std::vector<int> ints;
+
+    // return false dan isi error jika ekspresi tidak valid
+    bool compile(std::string_view expression, std::string &error);
+
+    int tag_index(std::string_view key) const {
+        for (size_t i = 0; i < tags.size(); ++i) {
+            if (tags[i] == key) return (int)i;
+        }
+        return -1;
+    }
+};
+
+// Nilai field satu game, diisi per baris header
+struct FilterValues {
+    uint64_t seen = 0;     // bit per field yang tag-nya sudah terbaca
+    uint64_t numeric = 0;  // bit per field yang angkanya valid
+    std::vector<std::string_view> text;
+    std::vector<int> number;
+};
+
+inline bool eval_conjunct(const FilterProgram &program, const FilterConjunct &conjunct, const FilterValues &values) {
+    uint64_t stack = 0;  // stack bool sebagai bit
+
+    for (uint32_t pc = conjunct.begin; pc < conjunct.end; ++pc) {
+        const FilterInstr &in = program.code[pc];
+        bool has_text = (values.seen >> in.field) & 1;
+        bool has_number = (values.numeric >> in.field) & 1;
+        int number = values.number[in.field];
+        std::string_view text = values.text[in.field];
+        bool r = false;
+
+        switch (in.op) {
+        case FilterOp::INT_CMP:
+            if (has_number) {
+                switch (in.cmp) {
+                case FilterCmp::EQ: r = number == in.a; break;
+                case FilterCmp::NE: r = number != in.a; break;
+                case FilterCmp::LT: r = number < in.a; break;
+                case FilterCmp::LE: r = number <= in.a; break;
+                case FilterCmp::GT: r = number > in.a; break;
+                case FilterCmp::GE: r = number >= in.a; break;
+                }
+            }
+            break;
+        case FilterOp::INT_RANGE:
+            r = has_number && number >= in.a && number <= in.b;
+            break;
+        case FilterOp::INT_IN:
+            for (int i = 0; has_number && !r && i < in.b; ++i) r = number == program.ints[in.a + i];
+            break;
+        case FilterOp::STR_EQ:
+            r = has_text && (text == program.strings[in.a]) == (in.cmp == FilterCmp::EQ);
+            break;
+        case FilterOp::STR_IN:
+            for (int i = 0; has_text && !r && i < in.b; ++i) r = text == program.strings[in.a + i];
+            break;
+        case FilterOp::GLOB:
+            r = has_text && glob_match(program.strings[in.a], text);
+            break;
+        case FilterOp::AND:
+            r = (stack & 1) && (stack & 2);
+            stack >>= 2;
+            break;
+        case FilterOp::OR:
+            r = (stack & 1) || (stack & 2);
+            stack >>= 2;
+            break;
+        case FilterOp::NOT:
+            r = !(stack & 1);
+            stack >>= 1;
+            break;
+        }
+        stack = (stack << 1) | (r ? 1 : 0);
+    }
+    return stack & 1;
+}
+
+// State filter per worker, dipakai ulang untuk semua game
+struct FilterState {
+    static const size_t REORDER_EVERY = 4096;  // game antar pengurutan ulang konjungsi
+
+    const FilterProgram *program = nullptr;
+    FilterValues values;
+    uint64_t evaluated = 0;  // bit per konjungsi yang sudah dicek untuk game ini
+    bool rejected = false;
+
+    // urutan cek konjungsi + statistik untuk mengurutkan ulang
+    std::vector<uint8_t> order;
+    std::vector<uint64_t> checks;
+    std::vector<uint64_t> rejects;
+    size_t games = 0;
+
+    explicit FilterState(const FilterProgram &filter) : program(&filter) {
+        values.text.resize(filter.fields.size());
+        values.number.resize(filter.fields.size());
+        for (size_t i = 0; i < filter.conjuncts.size(); ++i) order.push_back((uint8_t)i);
+        checks.assign(filter.conjuncts.size(), 0);
+        rejects.assign(filter.conjuncts.size(), 0);
+
+        // sebelum ada statistik: yang paling murah dulu
+        std::stable_sort(order.begin(), order.end(), [&](uint8_t a, uint8_t b) {
+            return filter.conjuncts[a].cost < filter.conjuncts[b].cost;
+        });
+    }
+
+    void reset() {
+        values.seen = 0;
+        values.numeric = 0;
+        evaluated = 0;
+        rejected = false;
+        if (++games % REORDER_EVERY == 0) reorder();
+    }
+
+    // cek konjungsi yang semua tag-nya sudah terbaca (all: cek semua sisanya).
+    // Return false jika game ditolak.
+    bool check(bool all) {
+        for (uint8_t i : order) {
+            const FilterConjunct &conjunct = program->conjuncts[i];
+            if ((evaluated >> i) & 1) continue;
+            if (!all && (values.seen & conjunct.field_mask) != conjunct.field_mask) continue;
+
+            evaluated |= uint64_t(1) << i;
+            checks[i]++;
+            if (!eval_conjunct(*program, conjunct, values)) {
+                rejects[i]++;
+                rejected = true;
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    // konjungsi dengan peluang menolak per cost terbesar dicek lebih dulu
+    void reorder() {
+        auto rank = [&](uint8_t i) {
+            double reject_rate = checks[i] ? (double)rejects[i] / checks[i] : 0.5;
+            return reject_rate / program->conjuncts[i].cost;
+        };
+        std::stable_sort(order.begin(), order.end(), [&](uint8_t a, uint8_t b) { return rank(a) > rank(b); });
+    }
+};
+
+// Cek satu baris header langsung saat dibaca, supaya game yang ditolak
+// tidak perlu disimpan maupun di-parse. Return false jika game pasti ditolak.
+inline bool filter_header_line(std::string_view header_line, FilterState &state) {
+    if (header_line.size() < 2 || header_line[0] != '[') return true;
+
+    size_t key_end = header_line.find(' ', 1);
+    if (key_end == std::string_view::npos) return true;
+
+    const FilterProgram &program = *state.program;
+    int tag = program.tag_index(header_line.substr(1, key_end - 1));
+    if (tag < 0) return true;  // tag lain tidak diekstrak
+
+    size_t start_val = header_line.find('"', key_end);
+    size_t end_val = header_line.rfind('"');
+    if (start_val == std::string_view::npos || end_val == std::string_view::npos) return true;
+
+    // tanpa kutip penutup: nilai sampai akhir baris
+    size_t end = end_val > start_val ? end_val : header_line.size();
+    std::string_view value = header_line.substr(start_val + 1, end - start_val - 1);
+
+    for (size_t f = 0; f < program.fields.size(); ++f) {
+        const FilterField &field = program.fields[f];
+        if (field.tag != tag) continue;
+
+        int number = 0;
+        bool ok;
+        size_t plus_sign = value.find('+');
+        if (field.source == FieldSource::TC_BASE) {
+            ok = parse_int(value, 0, std::min(plus_sign, value.size()), number);
+        } else if (field.source == FieldSource::TC_INCREMENT) {
+            ok = plus_sign != std::string_view::npos && parse_int(value, plus_sign + 1, value.size(), number);
+        } else {
+            ok = parse_int(value, 0, value.size(), number);
+        }
+
+        uint64_t bit = uint64_t(1) << f;
+        state.values.text[f] = value;
+        state.values.number[f] = number;
+        state.values.seen |= bit;
+        if (ok) state.values.numeric |= bit;
+    }
+    return state.check(false);
+}
+
+// dipanggil di akhir header: konjungsi yang tag-nya tidak ada dicek sekarang
+inline bool filter_game(FilterState &state) {
+    return !state.rejected && state.check(true);
+}
+
+// ---- compiler ----
+
+namespace filter_detail {
+
+struct Token {
+    enum Kind { END, IDENT, NUMBER, STRING, WORD, OP } kind = END;
+    std::string text;
+    int number = 0;
+    size_t pos = 0;
+};
+
+// AST sementara, hanya dipakai saat kompilasi
+struct Node {
+    FilterInstr instr;  // leaf, atau AND / OR / NOT
+    std::unique_ptr<Node> lhs, rhs;
+};
+
+class Parser {
+public:
+    Parser(std::string_view source, FilterProgram &program) : src(source), program(program) {}
+
+    bool parse(std::string &error) {
+        next();
+        std::unique_ptr<Node> root = parse_or();
+        if (root && tok.kind != Token::END) fail("unexpected '" + tok.text + "'");
+        if (!err.empty()) {
+            error = err;
+            return false;
+        }
+
+        std::vector<const Node *> terms;
+        split(root.get(), terms);
+        if (terms.size() > FilterProgram::MAX_CONJUNCTS) {
+            error = "too many && terms";
+            return false;
+        }
+
+        for (const Node *term : terms) {
+            FilterConjunct conjunct;
+            conjunct.begin = (uint32_t)program.code.size();
+            size_t depth = 0, max_depth = 0;
+            emit(term, conjunct, depth, max_depth);
+            if (max_depth > FilterProgram::MAX_STACK) {
+                error = "expression nested too deeply";
+                return false;
+            }
+            conjunct.end = (uint32_t)program.code.size();
+            program.conjuncts.push_back(conjunct);
+        }
+        return true;
+    }
+
+private:
+    std::string_view src;
+    FilterProgram &program;
+    size_t pos = 0;
+    Token tok;
+    std::string err;
+
+    bool fail(const std::string &message) {
+        if (err.empty()) err = message + " at position " + std::to_string(tok.pos);
+        return false;
+    }
+
+    // && paling luar dipecah menjadi konjungsi
+    static void split(const Node *node, std::vector<const Node *> &terms) {
+        if (node->instr.op == FilterOp::AND) {
+            split(node->lhs.get(), terms);
+            split(node->rhs.get(), terms);
+        } else {
+            terms.push_back(node);
+        }
+    }
+
+    // depth: tinggi stack saat instruksi ini jalan, max_depth untuk cek MAX_STACK
+    void emit(const Node *node, FilterConjunct &conjunct, size_t &depth, size_t &max_depth) {
+        if (node->lhs) emit(node->lhs.get(), conjunct, depth, max_depth);
+        if (node->rhs) emit(node->rhs.get(), conjunct, depth, max_depth);
+        depth = depth - (node->lhs ? 1 : 0) - (node->rhs ? 1 : 0) + 1;
+        max_depth = std::max(max_depth, depth);
+
+        const FilterInstr &in = node->instr;
+        switch (in.op) {
+        case FilterOp::INT_CMP:
+        case FilterOp::INT_RANGE:
+            conjunct.cost += 1;
+            break;
+        case FilterOp::INT_IN:
+        case FilterOp::STR_EQ:
+            conjunct.cost += 2;
+            break;
+        case FilterOp::STR_IN:
+            conjunct.cost += 2 + in.b;
+            break;
+        case FilterOp::GLOB:
+            conjunct.cost += 4;
+            break;
+        default:
+            break;
+        }
+        if (!node->lhs) conjunct.field_mask |= uint64_t(1) << in.field;
+        program.code.push_back(in);
+    }
+
+    void next(bool pattern = false) {
+        while (pos < src.size() && std::isspace((unsigned char)src[pos])) pos++;
+        tok = Token();
+        tok.pos = pos;
+        if (pos >= src.size()) return;
+
+        char c = src[pos];
+        if (c == '"') {
+            size_t close = src.find('"', pos + 1);
+            if (close == std::string_view::npos) {
+                tok.kind = Token::OP;
+                tok.text = "\"";
+                fail("unterminated string");
+                pos = src.size();
+                return;
+            }
+            tok.kind = Token::STRING;
+            tok.text = std::string(src.substr(pos + 1, close - pos - 1));
+            pos = close + 1;
+            return;
+        }
+
+        if (pattern) {
+            // pola glob tanpa kutip: sampai spasi atau operator
+            size_t start = pos;
+            while (pos < src.size() && !std::isspace((unsigned char)src[pos]) &&
+                   std::string_view("&|()").find(src[pos]) == std::string_view::npos) {
+                pos++;
+            }
+            tok.kind = Token::WORD;
+            tok.text = std::string(src.substr(start, pos - start));
+            return;
+        }
+
+        if (std::isdigit((unsigned char)c) ||
+            (c == '-' && pos + 1 < src.size() && std::isdigit((unsigned char)src[pos + 1]))) {
+            size_t start = pos++;
+            while (pos < src.size() && std::isalnum((unsigned char)src[pos])) pos++;
+            tok.text = std::string(src.substr(start, pos - start));
+            int number = 0;
+            bool digits_only = tok.text.find_first_not_of("-0123456789") == std::string::npos;
+            tok.kind = digits_only && parse_int(tok.text, 0, tok.text.size(), number) ? Token::NUMBER : Token::WORD;
+            tok.number = number;
+            return;
+        }
+
+        if (std::isalpha((unsigned char)c) || c == '_') {
+            size_t start = pos;
+            while (pos < src.size() && (std::isalnum((unsigned char)src[pos]) || src[pos] == '_')) pos++;
+            tok.kind = Token::IDENT;
+            tok.text = std::string(src.substr(start, pos - start));
+            return;
+        }
+
+        static const char *OPERATORS[] = { "&&", "||", "==", "!=", "<=", ">=", "<", ">", "!", "~", "(", ")", "[", "]", "{", "}", "," };
+        for (const char *op : OPERATORS) {
+            if (src.compare(pos, std::char_traits<char>::length(op), op) == 0) {
+                tok.kind = Token::OP;
+                tok.text = op;
+                pos += tok.text.size();
+                return;
+            }
+        }
+
+        tok.kind = Token::OP;
+        tok.text = std::string(1, c);
+        fail("unexpected character '" + tok.text + "'");
+        pos = src.size();
+    }
+
+    bool is_op(const char *op) const {
+        return tok.kind == Token::OP && tok.text == op;
+    }
+
+    bool accept(const char *op) {
+        if (!is_op(op)) return false;
+        next();
+        return true;
+    }
+
+    bool expect(const char *op) {
+        return accept(op) || fail(std::string("expected '") + op + "'");
+    }
+
+    static std::unique_ptr<Node> binary(FilterOp op, std::unique_ptr<Node> lhs, std::unique_ptr<Node> rhs) {
+        auto node = std::make_unique<Node>();
+        node->instr.op = op;
+        node->lhs = std::move(lhs);
+        node->rhs = std::move(rhs);
+        return node;
+    }
+
+    std::unique_ptr<Node> parse_or() {
+        std::unique_ptr<Node> lhs = parse_and();
+        while (lhs && accept("||")) {
+            std::unique_ptr<Node> rhs = parse_and();
+            if (!rhs) return nullptr;
+            lhs = binary(FilterOp::OR, std::move(lhs), std::move(rhs));
+        }
+        return lhs;
+    }
+
+    std::unique_ptr<Node> parse_and() {
+        std::unique_ptr<Node> lhs = parse_unary();
+        while (lhs && accept("&&")) {
+            std::unique_ptr<Node> rhs = parse_unary();
+            if (!rhs) return nullptr;
+            lhs = binary(FilterOp::AND, std::move(lhs), std::move(rhs));
+        }
+        return lhs;
+    }
+
+    std::unique_ptr<Node> parse_unary() {
+        if (accept("!")) {
+            std::unique_ptr<Node> operand = parse_unary();
+            if (!operand) return nullptr;
+            auto node = std::make_unique<Node>();
+            node->instr.op = FilterOp::NOT;
+            node->lhs = std::move(operand);
+            return node;
+        }
+        if (accept("(")) {
+            std::unique_ptr<Node> inner = parse_or();
+            if (!inner || !expect(")")) return nullptr;
+            return inner;
+        }
+        return parse_comparison();
+    }
+
+    static std::unique_ptr<Node> leaf(FilterOp op, FilterCmp cmp, int field, int a, int b = 0) {
+        auto node = std::make_unique<Node>();
+        node->instr.op = op;
+        node->instr.cmp = cmp;
+        node->instr.field = (uint8_t)field;
+        node->instr.a = a;
+        node->instr.b = b;
+        return node;
+    }
+
+    int field_index(const std::string &name) {
+        for (size_t i = 0; i < program.fields.size(); ++i) {
+            if (program.fields[i].name == name) return (int)i;
+        }
+        if (program.fields.size() >= FilterProgram::MAX_FIELDS) {
+            fail("too many fields");
+            return -1;
+        }
+
+        FilterField field;
+        field.name = name;
+        std::string tag = name;
+        if (name == "base" || name == "increment") {
+            tag = "TimeControl";
+            field.source = name == "base" ? FieldSource::TC_BASE : FieldSource::TC_INCREMENT;
+        }
+        int index = program.tag_index(tag);
+        if (index < 0) {
+            index = (int)program.tags.size();
+            program.tags.push_back(tag);
+        }
+        field.tag = (uint8_t)index;
+        program.fields.push_back(field);
+        return (int)program.fields.size() - 1;
+    }
+
+    bool is_value() const {
+        return tok.kind == Token::NUMBER || tok.kind == Token::STRING || tok.kind == Token::IDENT ||
+               tok.kind == Token::WORD;
+    }
+
+    std::unique_ptr<Node> parse_comparison() {
+        if (tok.kind != Token::IDENT) {
+            fail("expected field name");
+            return nullptr;
+        }
+        std::string name = tok.text;
+        next();
+        int field = field_index(name);
+        if (field < 0) return nullptr;
+
+        if (tok.kind == Token::IDENT && tok.text == "in") {
+            next();
+            return parse_in(field);
+        }
+
+        if (is_op("~")) {
+            next(true);
+            if (tok.kind != Token::STRING && tok.kind != Token::WORD) {
+                fail("expected pattern after '~'");
+                return nullptr;
+            }
+            program.strings.push_back(tok.text);
+            next();
+            return leaf(FilterOp::GLOB, FilterCmp::EQ, field, (int)program.strings.size() - 1);
+        }
+
+        static const std::pair<const char *, FilterCmp> CMPS[] = {
+            { "==", FilterCmp::EQ }, { "!=", FilterCmp::NE }, { "<=", FilterCmp::LE },
+            { ">=", FilterCmp::GE }, { "<", FilterCmp::LT }, { ">", FilterCmp::GT },
+        };
+        const std::pair<const char *, FilterCmp> *cmp = nullptr;
+        for (const auto &c : CMPS) {
+            if (is_op(c.first)) cmp = &c;
+        }
+        if (!cmp) {
+            fail("expected operator after '" + name + "'");
+            return nullptr;
+        }
+        next();
+
+        if (tok.kind == Token::NUMBER) {
+            int value = tok.number;
+            next();
+            return leaf(FilterOp::INT_CMP, cmp->second, field, value);
+        }
+        if (!is_value()) {
+            fail("expected value");
+            return nullptr;
+        }
+        if (cmp->second != FilterCmp::EQ && cmp->second != FilterCmp::NE) {
+            fail(std::string("'") + cmp->first + "' needs a number");
+            return nullptr;
+        }
+        program.strings.push_back(tok.text);
+        next();
+        return leaf(FilterOp::STR_EQ, cmp->second, field, (int)program.strings.size() - 1);
+    }
+
+    std::unique_ptr<Node> parse_in(int field) {
+        if (accept("[")) {
+            int bounds[2];
+            for (int i = 0; i < 2; ++i) {
+                if (tok.kind != Token::NUMBER) {
+                    fail("expected number");
+                    return nullptr;
+                }
+                bounds[i] = tok.number;
+                next();
+                if (!expect(i == 0 ? "," : "]")) return nullptr;
+            }
+            return leaf(FilterOp::INT_RANGE, FilterCmp::EQ, field, bounds[0], bounds[1]);
+        }
+
+        if (!expect("{")) return nullptr;
+        std::vector<Token> items;
+        bool numeric = true;
+        do {
+            if (!is_value()) {
+                fail("expected value in set");
+                return nullptr;
+            }
+            numeric &= tok.kind == Token::NUMBER;
+            items.push_back(tok);
+            next();
+        } while (accept(","));
+        if (!expect("}")) return nullptr;
+
+        if (numeric) {
+            int begin = (int)program.ints.size();
+            for (const auto &item : items) program.ints.push_back(item.number);
+            return leaf(FilterOp::INT_IN, FilterCmp::EQ, field, begin, (int)items.size());
+        }
+        int begin = (int)program.strings.size();
+        for (const auto &item : items) program.strings.push_back(item.text);
+        return leaf(FilterOp::STR_IN, FilterCmp::EQ, field, begin, (int)items.size());
+    }
+};
+
+}  // namespace filter_detail
+
+inline bool FilterProgram::compile(std::string_view expression, std::string &error) {
+    *this = FilterProgram();
+    source = std::string(expression);
+    filter_detail::Parser parser(expression, *this);
+    return parser.parse(error);
+}
@@ -0,0 +1,355 @@
+#pragma once
+
+// Pembaca PGN bersama untuk tool kecil (cek_data, test_2, bench, aggregator):
+// satu loop zstd ber-buffer dan satu aturan batas game, tanpa getline /
+// stringstream per baris. Aturan batas game / header (find_game_start,
+// scan_header) dan deteksi zstd (is_zstd_magic) juga dipakai generate_data.
+//
+//   PgnStreamReader reader("lichess.pgn.zst");
+//   for (const GameView &game : reader) {
+//       std::string_view elo = game.tag("WhiteElo");
+//       ...
+//   }
+//   if (!reader.ok()) cerr << "[ERROR] " << reader.error() << endl;
+//
+// Thread prefetch mendekompresi chunk berikutnya (~4 MB, dipotong di awal
+// game terakhir) selagi chunk sekarang dibaca. Game dimulai di baris
+// "[Event " seperti generate_data; baris kosong di tengah header (game 2358
+// di dump 2025-12) tidak memotong game. GameView hanya view ke chunk dan
+// valid sampai next() berikutnya.
+//
+// C++17: generator coroutine belum bisa dipakai, API-nya pull (next) dan
+// iterator input untuk range-for.
+
+#include <zstd.h>
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// nilai tag di teks header, kosong jika tidak ada
+inline std::string_view header_tag(std::string_view header, std::string_view key) {
+    size_t pos = 0;
+    while (pos < header.size()) {
+        size_t nl = std::min(header.find('\n', pos), header.size());
+        std::string_view line = header.substr(pos, nl - pos);
+        if (line.size() > key.size() + 2 && line[0] == '[' && line.compare(1, key.size(), key) == 0 &&
+            line[key.size() + 1] == ' ') {
+            size_t start_val = line.find('"', key.size() + 1);
+            size_t end_val = line.rfind('"');
+            if (start_val == std::string_view::npos || end_val <= start_val) return {};
+            return line.substr(start_val + 1, end_val - start_val - 1);
+        }
+        pos = nl + 1;
+    }
+    return {};
+}
+
+// Satu game di dalam buffer, tanpa salinan
+struct GameView {
+    std::string_view header;    // baris tag
+    std::string_view movetext;  // sisa game setelah header
+    std::string_view text;      // seluruh game
+
+    std::string_view tag(std::string_view key) const {
+        return header_tag(header, key);
+    }
+
+    // fn(key, value) untuk setiap baris tag, urut seperti di PGN
+    template <typename F>
+    void for_each_tag(F fn) const {
+        size_t pos = 0;
+        while (pos < header.size()) {
+            size_t nl = std::min(header.find('\n', pos), header.size());
+            std::string_view line = header.substr(pos, nl - pos);
+            pos = nl + 1;
+            if (line.empty() || line[0] != '[') continue;
+
+            size_t end_key = line.find(' ');
+            size_t start_val = line.find('"');
+            size_t end_val = line.rfind('"');
+            if (end_key == std::string_view::npos || start_val == std::string_view::npos || end_val <= start_val) {
+                continue;
+            }
+            fn(line.substr(1, end_key - 1), line.substr(start_val + 1, end_val - start_val - 1));
+        }
+    }
+};
+
+// Aturan header satu game: header = baris "[..." dari awal (baris kosong di
+// antaranya dilewati), movetext mulai dari baris pertama yang bukan tag.
+// fn(line) dipanggil untuk tiap baris tag; jika false, scan berhenti di situ
+// (mis. tag ditolak filter) dan scan_header mengembalikan false.
+template <typename F>
+inline bool scan_header(std::string_view text, size_t &header_end, size_t &movetext_start, F &&fn) {
+    size_t pos = 0;
+    header_end = 0;
+    while (pos < text.size()) {
+        size_t nl = std::min(text.find('\n', pos), text.size());
+        std::string_view line = text.substr(pos, nl - pos);
+        bool blank = line.empty() || line == "\r";
+        if (!blank && line[0] != '[') break;
+        if (!blank) {
+            if (!fn(line)) return false;
+            header_end = nl;
+        }
+        pos = nl + 1;
+    }
+    movetext_start = std::min(pos, text.size());
+    return true;
+}
+
+// Pecah satu game menurut scan_header
+inline GameView split_game(std::string_view text) {
+    size_t header_end, movetext_start;
+    scan_header(text, header_end, movetext_start, [](std::string_view) { return true; });
+    return GameView{ text.substr(0, header_end), text.substr(movetext_start), text };
+}
+
+// awal game berikutnya (baris "[Event ") mulai dari pos, npos jika tidak ada
+inline size_t find_game_start(std::string_view text, size_t pos) {
+    if (pos == 0 && text.rfind("[Event ", 0) == 0) return 0;
+    size_t found = text.find("\n[Event ", pos > 0 ? pos - 1 : 0);
+    return found == std::string_view::npos ? found : found + 1;
+}
+
+// Frame zstd biasa atau skippable frame di awal input: zstd dikenali dari
+// magic byte, bukan dari ekstensi file
+inline bool is_zstd_magic(const char *bytes, size_t size) {
+    if (size < 4) return false;
+    const unsigned char *p = (const unsigned char *)bytes;
+    uint32_t magic = p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
+    return magic == ZSTD_MAGICNUMBER || (magic & ZSTD_MAGIC_SKIPPABLE_MASK) == ZSTD_MAGIC_SKIPPABLE_START;
+}
+
+class PgnStreamReader {
+public:
+    static const size_t CHUNK_BYTES = 4 << 20;
+    static const size_t PREFETCH_CHUNKS = 2;  // chunk siap pakai yang menunggu di depan
+
+    // input zstd (dari magic byte) didekompresi, selain itu dibaca apa adanya
+    explicit PgnStreamReader(const std::string &path, size_t chunk_bytes = CHUNK_BYTES)
+        : path(path), chunk_bytes(chunk_bytes), file(path, std::ios::binary) {
+        if (!file) {
+            failure = "Cannot open file: " + path;
+            done = true;
+            return;
+        }
+        char magic[4];
+        file.read(magic, sizeof(magic));
+        compressed = is_zstd_magic(magic, (size_t)file.gcount());
+        file.clear();
+        file.seekg(0);
+        prefetch_thread = std::thread([this]() { prefetch(); });
+    }
+
+    ~PgnStreamReader() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        cv.notify_all();
+        if (prefetch_thread.joinable()) prefetch_thread.join();
+    }
+
+    PgnStreamReader(const PgnStreamReader &) = delete;
+    PgnStreamReader &operator=(const PgnStreamReader &) = delete;
+
+    // game berikutnya, false di akhir stream atau jika ada error (lihat ok())
+    bool next(GameView &game) {
+        for (;;) {
+            std::string_view text = current;
+            size_t start = find_game_start(text, pos);
+            if (start != std::string_view::npos) {
+                size_t end = find_game_start(text, start + 1);
+                if (end == std::string_view::npos) end = text.size();
+                game = split_game(text.substr(start, end - start));
+                pos = end;
+                scanned++;
+                return true;
+            }
+            if (!fetch()) return false;
+        }
+    }
+
+    bool ok() const {
+        return failure.empty();
+    }
+
+    const std::string &error() const {
+        return failure;
+    }
+
+    uint64_t games() const {
+        return scanned;
+    }
+
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = GameView;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const GameView *;
+        using reference = const GameView &;
+
+        iterator() = default;
+        explicit iterator(PgnStreamReader *reader) : reader(reader) {
+            ++*this;
+        }
+
+        const GameView &operator*() const {
+            return game;
+        }
+
+        const GameView *operator->() const {
+            return &game;
+        }
+
+        iterator &operator++() {
+            if (reader && !reader->next(game)) reader = nullptr;
+            return *this;
+        }
+
+        bool operator==(const iterator &other) const {
+            return reader == other.reader;
+        }
+
+        bool operator!=(const iterator &other) const {
+            return reader != other.reader;
+        }
+
+    private:
+        PgnStreamReader *reader = nullptr;
+        GameView game;
+    };
+
+    iterator begin() {
+        return iterator(this);
+    }
+
+    iterator end() {
+        return iterator();
+    }
+
+private:
+    std::string path;
+    size_t chunk_bytes;
+    std::ifstream file;
+    bool compressed = false;
+
+    // sisi pembaca: chunk yang sedang di-scan dan posisi di dalamnya
+    std::string current;
+    size_t pos = 0;
+    uint64_t scanned = 0;
+    std::string failure;
+
+    // antrian chunk dari thread prefetch, buffer bekas kembali lewat spare
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::string> ready;
+    std::vector<std::string> spare;
+    bool done = false;
+    bool stop = false;
+    std::string prefetch_error;
+    std::thread prefetch_thread;
+
+    // ganti current dengan chunk berikutnya, false jika stream habis
+    bool fetch() {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&] { return !ready.empty() || done; });
+        if (ready.empty()) {
+            if (!prefetch_error.empty() && failure.empty()) failure = prefetch_error;
+            return false;
+        }
+        current.clear();
+        spare.push_back(std::move(current));
+        current = std::move(ready.front());
+        ready.pop_front();
+        pos = 0;
+        cv.notify_all();
+        return true;
+    }
+
+    // kirim chunk ke pembaca, menunggu jika PREFETCH_CHUNKS sudah antri.
+    // false jika reader sudah ditutup.
+    bool publish(std::string &&chunk) {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&] { return ready.size() < PREFETCH_CHUNKS || stop; });
+        if (stop) return false;
+        ready.push_back(std::move(chunk));
+        cv.notify_all();
+        return true;
+    }
+
+    // buffer bekas pembaca jika ada, supaya chunk tidak alokasi ulang
+    std::string spare_buffer() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (spare.empty()) return std::string();
+        std::string buffer = std::move(spare.back());
+        spare.pop_back();
+        return buffer;
+    }
+
+    void finish(const std::string &error) {
+        std::lock_guard<std::mutex> lock(mutex);
+        prefetch_error = error;
+        done = true;
+        cv.notify_all();
+    }
+
+    void prefetch() {
+        std::string error;
+        std::string pending;
+        pending.reserve(chunk_bytes + (chunk_bytes >> 2));
+
+        ZSTD_DStream *dstream = compressed ? ZSTD_createDStream() : nullptr;
+        if (dstream) ZSTD_initDStream(dstream);
+        std::vector<char> in_buf(compressed ? ZSTD_DStreamInSize() : 1 << 20);
+        std::vector<char> out_buf(compressed ? ZSTD_DStreamOutSize() : 0);
+
+        bool running = true;
+        while (running && error.empty()) {
+            file.read(in_buf.data(), in_buf.size());
+            size_t bytes_read = (size_t)file.gcount();
+            if (bytes_read == 0) break;
+
+            if (!compressed) {
+                pending.append(in_buf.data(), bytes_read);
+            } else {
+                ZSTD_inBuffer input{ in_buf.data(), bytes_read, 0 };
+                while (input.pos < input.size) {
+                    ZSTD_outBuffer output{ out_buf.data(), out_buf.size(), 0 };
+                    size_t ret = ZSTD_decompressStream(dstream, &output, &input);
+                    if (ZSTD_isError(ret)) {
+                        error = std::string("ZSTD decompress error: ") + ZSTD_getErrorName(ret);
+                        break;
+                    }
+                    pending.append(out_buf.data(), output.pos);
+                }
+            }
+            if (!error.empty() || pending.size() < chunk_bytes) continue;
+
+            // potong di awal game terakhir, game terpotong jadi awal chunk berikutnya
+            size_t cut = std::string_view(pending).rfind("\n[Event ");
+            if (cut == std::string_view::npos || cut == 0) continue;  // satu game lebih besar dari chunk
+
+            std::string tail = spare_buffer();
+            tail.assign(pending, cut + 1, std::string::npos);
+            pending.resize(cut + 1);
+            running = publish(std::move(pending));
+            pending = std::move(tail);
+        }
+
+        if (running && error.empty() && !pending.empty()) publish(std::move(pending));
+        if (dstream) ZSTD_freeDStream(dstream);
+        finish(error);
+    }
+};
@@ -0,0 +1,165 @@
+#pragma once
+
+// Scanner struktural PGN ala simdjson. Stage 1: satu pass per blok 64 byte
+// menghasilkan bitmask posisi karakter struktural ('\n', '[', '"', '{', '}',
+// '\r'), stage 2: for_each mengunjungi bit-bit itu berurutan (lsb, hapus bit
+// terendah), jadi batas baris, nilai tag dan komentar didapat dari operasi
+// bit dan bukan find / memchr per baris yang dipanggil jutaan kali.
+//
+// Kernel dipilih saat runtime: AVX2, SSE2 (128 bit, selalu ada di x86-64)
+// atau scalar. Hasil semua kernel identik, lihat bench_pgn_scan.cpp.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define PGN_SCAN_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(PGN_SCAN_X86) && (defined(__GNUC__) || defined(__clang__))
+#define PGN_SCAN_TARGET(isa) __attribute__((target(isa)))
+#else
+#define PGN_SCAN_TARGET(isa)
+#endif
+
+#include "chess_board.h"  // chess::lsb
+
+namespace pgn_scan {
+
+enum Class { NEWLINE, BRACKET, QUOTE, BRACE_OPEN, BRACE_CLOSE, RETURN, CLASS_COUNT };
+
+static const char CLASS_CHARS[CLASS_COUNT] = { '\n', '[', '"', '{', '}', '\r' };
+static const size_t BLOCK = 64;
+
+// bits[k]: bit i menyala jika byte ke-i blok sama dengan chars[k]. Blok
+// dibaca sekali untuk semua karakter, satu panggilan kernel per blok.
+using ScanFn = void (*)(const char *block, const char *chars, int count, uint64_t *bits);
+
+inline void scan_block_scalar(const char *block, const char *chars, int count, uint64_t *bits) {
+    for (int k = 0; k < count; ++k) bits[k] = 0;
+    for (size_t i = 0; i < BLOCK; ++i) {
+        for (int k = 0; k < count; ++k) bits[k] |= (uint64_t)(block[i] == chars[k]) << i;
+    }
+}
+
+#ifdef PGN_SCAN_X86
+PGN_SCAN_TARGET("sse2")
+inline void scan_block_sse2(const char *block, const char *chars, int count, uint64_t *bits) {
+    __m128i lanes[4];
+    for (int i = 0; i < 4; ++i) lanes[i] = _mm_loadu_si128((const __m128i *)(block + 16 * i));
+    for (int k = 0; k < count; ++k) {
+        __m128i needle = _mm_set1_epi8(chars[k]);
+        uint64_t found = 0;
+        for (int i = 0; i < 4; ++i) {
+            found |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(lanes[i], needle)) << (16 * i);
+        }
+        bits[k] = found;
+    }
+}
+
+PGN_SCAN_TARGET("avx2")
+inline void scan_block_avx2(const char *block, const char *chars, int count, uint64_t *bits) {
+    __m256i lo = _mm256_loadu_si256((const __m256i *)block);
+    __m256i hi = _mm256_loadu_si256((const __m256i *)(block + 32));
+    for (int k = 0; k < count; ++k) {
+        __m256i needle = _mm256_set1_epi8(chars[k]);
+        uint32_t low = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, needle));
+        uint32_t high = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, needle));
+        bits[k] = (uint64_t)high << 32 | low;
+    }
+}
+
+// AVX2 butuh dukungan CPU dan OS (register ymm disimpan saat context switch)
+inline bool cpu_has_avx2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    bool osxsave = (info[2] >> 27) & 1;
+    if (!osxsave || (_xgetbv(0) & 6) != 6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] >> 5) & 1;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+struct Kernel {
+    const char *name;
+    ScanFn scan;
+};
+
+// kernel yang bisa jalan di CPU ini, terbaik dulu
+inline std::vector<Kernel> available_kernels() {
+    std::vector<Kernel> kernels;
+#ifdef PGN_SCAN_X86
+    if (cpu_has_avx2()) kernels.push_back({ "avx2", scan_block_avx2 });
+    kernels.push_back({ "sse2", scan_block_sse2 });
+#endif
+    kernels.push_back({ "scalar", scan_block_scalar });
+    return kernels;
+}
+
+inline Kernel &active_kernel() {
+    static Kernel kernel = available_kernels().front();
+    return kernel;
+}
+
+// pilih kernel (nama dari available_kernels), false jika tidak tersedia.
+// Panggil sebelum thread worker mulai.
+inline bool set_kernel(std::string_view name) {
+    for (const Kernel &kernel : available_kernels()) {
+        if (name == kernel.name) {
+            active_kernel() = kernel;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Stage 2: fn(pos, kelas) untuk setiap karakter kelas `classes` di
+// [begin, end), urut posisi. fn return false untuk berhenti. Return posisi
+// karakter tempat berhenti, end jika semua dikunjungi.
+template <size_t N, typename F>
+size_t for_each(std::string_view text, size_t begin, size_t end, const Class (&classes)[N], F fn) {
+    ScanFn scan = active_kernel().scan;
+    char chars[N];
+    for (size_t k = 0; k < N; ++k) chars[k] = CLASS_CHARS[classes[k]];
+
+    end = std::min(end, text.size());
+    for (size_t block = begin - begin % BLOCK; block < end; block += BLOCK) {
+        uint64_t bits[N];
+        if (text.size() - block >= BLOCK) {
+            scan(text.data() + block, chars, (int)N, bits);
+        } else {
+            // blok terakhir: sisa byte diisi 0 (bukan karakter kelas mana pun)
+            char tail[BLOCK] = {};
+            memcpy(tail, text.data() + block, text.size() - block);
+            scan(tail, chars, (int)N, bits);
+        }
+
+        uint64_t all = 0;
+        for (size_t k = 0; k < N; ++k) all |= bits[k];
+        if (block < begin) all &= ~uint64_t(0) << (begin - block);
+        if (end - block < BLOCK) all &= (uint64_t(1) << (end - block)) - 1;
+
+        for (; all; all &= all - 1) {
+            uint64_t bit = all & (0 - all);
+            size_t k = 0;
+            while (!(bits[k] & bit)) k++;
+            size_t pos = block + chess::lsb(all);
+            if (!fn(pos, classes[k])) return pos;
+        }
+    }
+    return end;
+}
+
+}  // namespace pgn_scan
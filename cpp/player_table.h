@@ -0,0 +1,299 @@
+#pragma once
+
+// Agregasi per pemain untuk generate_data --format players. Nama pemain
+// di-intern sekali per tabel (StringArena, dicari lewat hash nama) di tabel
+// open addressing dengan batas memori tetap, seperti OpeningTree: satu tabel
+// per worker sebagai shard tanpa lock, digabung di akhir scan.
+//
+// Jika tabel terisi 3/4, pemain dengan game paling sedikit dibuang sampai
+// minimal separuh slot kosong dan evicted_below naik: pemain dengan game
+// kurang dari evicted_below bisa kurang terhitung. Nama yang tersisa disalin
+// ke arena baru, jadi memori nama ikut terbatas.
+
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "arena.h"
+
+enum TimeClass { TC_BULLET, TC_BLITZ, TC_RAPID, TC_CLASSICAL, TC_CORRESPONDENCE, TIME_CLASS_COUNT };
+
+static const int PLAYER_WEEKS = 5;      // hari 1-7, 8-14, 15-21, 22-28, 29-31 (dump bulanan)
+static const int PLAYER_ECOS = 8;       // counter SpaceSaving ECO per pemain
+static const int NO_RATING = INT_MIN;
+
+// Satu game dilihat dari sisi satu pemain
+struct PlayerGame {
+    std::string_view name;
+    uint64_t order = 0;       // urutan game di stream, untuk rating awal / akhir
+    int rating = NO_RATING;   // Elo sebelum game
+    int rating_after = NO_RATING;  // Elo + RatingDiff (Elo jika diff tidak ada)
+    int score = -1;           // 2 menang, 1 remis, 0 kalah, -1 tanpa hasil
+    bool white = false;
+    int time_class = -1;
+    int week = -1;
+    int eco = -1;             // 0-499 untuk A00-E99
+};
+
+struct PlayerEntry {
+    uint64_t key = 0;         // hash nama, 0 = slot kosong
+    std::string_view name;    // di arena milik tabel
+    uint64_t first_order = UINT64_MAX;
+    uint64_t last_order = 0;
+    uint32_t games = 0;
+    uint32_t white_games = 0;
+    uint32_t wins = 0;
+    uint32_t draws = 0;
+    uint32_t losses = 0;
+    uint32_t time_classes[TIME_CLASS_COUNT] = {};
+    int16_t first_rating = INT16_MIN;  // INT16_MIN = belum ada
+    int16_t last_rating = INT16_MIN;
+    int16_t min_rating = INT16_MAX;
+    int16_t max_rating = INT16_MIN;
+    uint32_t week_rating_sum[PLAYER_WEEKS] = {};  // rating sesudah game, rata-rata per minggu
+    uint32_t week_games[PLAYER_WEEKS] = {};
+    uint16_t ecos[PLAYER_ECOS] = {};              // kode ECO + 1, 0 = counter kosong
+    uint32_t eco_counts[PLAYER_ECOS] = {};
+    uint32_t eco_error = 0;  // eco_counts bisa lebih dari count asli paling banyak sebesar ini, 0 = persis
+
+    // SpaceSaving: count >= count asli, dan count asli ECO yang tidak punya
+    // counter <= counter terkecil. Kelebihan paling banyak games / PLAYER_ECOS.
+    void add_eco(uint16_t code) {
+        int low = 0;
+        for (int i = 0; i < PLAYER_ECOS; ++i) {
+            if (ecos[i] == code) {
+                eco_counts[i]++;
+                return;
+            }
+            if (!ecos[i]) {
+                ecos[i] = code;
+                eco_counts[i] = 1;
+                return;
+            }
+            if (eco_counts[i] < eco_counts[low]) low = i;
+        }
+        // semua counter terisi: ambil alih counter terkecil
+        eco_error = std::max(eco_error, eco_counts[low]);
+        ecos[low] = code;
+        eco_counts[low]++;
+    }
+
+    // gabungan dua ringkasan SpaceSaving (mergeable summaries): ECO yang tidak
+    // punya counter di satu sisi dihitung sebesar counter terkecil sisi itu
+    // (jika penuh), lalu PLAYER_ECOS counter terbesar disimpan
+    void merge_ecos(const PlayerEntry &other) {
+        uint16_t codes[2 * PLAYER_ECOS];
+        uint32_t counts[2 * PLAYER_ECOS];
+        int n = 0;
+        uint32_t floor = eco_floor(), other_floor = other.eco_floor(), added = 0;
+        for (int i = 0; i < PLAYER_ECOS && ecos[i]; ++i) {
+            int j = other.find_eco(ecos[i]);
+            if (j < 0) added = std::max(added, other_floor);
+            codes[n] = ecos[i];
+            counts[n++] = eco_counts[i] + (j < 0 ? other_floor : other.eco_counts[j]);
+        }
+        for (int j = 0; j < PLAYER_ECOS && other.ecos[j]; ++j) {
+            if (find_eco(other.ecos[j]) >= 0) continue;
+            added = std::max(added, floor);
+            codes[n] = other.ecos[j];
+            counts[n++] = other.eco_counts[j] + floor;
+        }
+
+        int order[2 * PLAYER_ECOS];
+        for (int i = 0; i < n; ++i) order[i] = i;
+        std::sort(order, order + n, [&](int a, int b) {
+            if (counts[a] != counts[b]) return counts[a] > counts[b];
+            return codes[a] < codes[b];
+        });
+        for (int i = 0; i < PLAYER_ECOS; ++i) {
+            ecos[i] = i < n ? codes[order[i]] : 0;
+            eco_counts[i] = i < n ? counts[order[i]] : 0;
+        }
+        eco_error += other.eco_error + added;
+    }
+
+private:
+    int find_eco(uint16_t code) const {
+        for (int i = 0; i < PLAYER_ECOS && ecos[i]; ++i) {
+            if (ecos[i] == code) return i;
+        }
+        return -1;
+    }
+
+    // batas atas count asli ECO tanpa counter
+    uint32_t eco_floor() const {
+        if (!ecos[PLAYER_ECOS - 1]) return 0;
+        return *std::min_element(eco_counts, eco_counts + PLAYER_ECOS);
+    }
+};
+
+class PlayerTable {
+public:
+    uint32_t evicted_below = 0;  // 0: tidak pernah ada eviction
+    uint64_t evictions = 0;
+
+    explicit PlayerTable(size_t memory_bytes) {
+        // slot + perkiraan nama (rata-rata < 16 byte) per slot
+        size_t capacity = 1024;
+        while (capacity * 2 * (sizeof(PlayerEntry) + 16) <= memory_bytes) capacity *= 2;
+        table.resize(capacity);
+        mask = capacity - 1;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    const std::vector<PlayerEntry> &slots() const {
+        return table;
+    }
+
+    void add(const PlayerGame &game) {
+        PlayerEntry &entry = insert(game.name);
+        entry.games++;
+        if (game.white) entry.white_games++;
+        if (game.score == 2) entry.wins++;
+        else if (game.score == 1) entry.draws++;
+        else if (game.score == 0) entry.losses++;
+        if (game.time_class >= 0) entry.time_classes[game.time_class]++;
+        if (game.eco >= 0) entry.add_eco((uint16_t)(game.eco + 1));
+        if (game.rating == NO_RATING) return;
+
+        int16_t before = clamp_rating(game.rating), after = clamp_rating(game.rating_after);
+        if (game.order < entry.first_order) {
+            entry.first_order = game.order;
+            entry.first_rating = before;
+        }
+        if (game.order >= entry.last_order) {
+            entry.last_order = game.order;
+            entry.last_rating = after;
+        }
+        entry.min_rating = std::min({ entry.min_rating, before, after });
+        entry.max_rating = std::max({ entry.max_rating, before, after });
+        if (game.week >= 0) {
+            entry.week_rating_sum[game.week] += (uint32_t)std::max<int>(after, 0);
+            entry.week_games[game.week]++;
+        }
+    }
+
+    // gabungkan tabel worker lain, nama disalin ke arena tabel ini
+    void merge(const PlayerTable &other) {
+        evicted_below = std::max(evicted_below, other.evicted_below);
+        evictions += other.evictions;
+        for (const PlayerEntry &from : other.table) {
+            if (!from.key) continue;
+            PlayerEntry &entry = insert(from.name);
+            entry.games += from.games;
+            entry.white_games += from.white_games;
+            entry.wins += from.wins;
+            entry.draws += from.draws;
+            entry.losses += from.losses;
+            for (int i = 0; i < TIME_CLASS_COUNT; ++i) entry.time_classes[i] += from.time_classes[i];
+            entry.merge_ecos(from);
+            if (from.first_rating == INT16_MIN) continue;
+
+            if (from.first_order < entry.first_order) {
+                entry.first_order = from.first_order;
+                entry.first_rating = from.first_rating;
+            }
+            if (from.last_order >= entry.last_order) {
+                entry.last_order = from.last_order;
+                entry.last_rating = from.last_rating;
+            }
+            entry.min_rating = std::min(entry.min_rating, from.min_rating);
+            entry.max_rating = std::max(entry.max_rating, from.max_rating);
+            for (int w = 0; w < PLAYER_WEEKS; ++w) {
+                entry.week_rating_sum[w] += from.week_rating_sum[w];
+                entry.week_games[w] += from.week_games[w];
+            }
+        }
+    }
+
+    void release() {
+        std::vector<PlayerEntry>().swap(table);
+        names = StringArena();
+        count = 0;
+        mask = 0;
+    }
+
+    static uint64_t hash(std::string_view name) {
+        uint64_t h = 14695981039346656037ull;  // FNV-1a
+        for (char c : name) h = (h ^ (unsigned char)c) * 1099511628211ull;
+        return h ? h : 1;
+    }
+
+private:
+    std::vector<PlayerEntry> table;
+    StringArena names;
+    size_t mask = 0;
+    size_t count = 0;
+
+    static int16_t clamp_rating(int rating) {
+        return (int16_t)std::clamp(rating, 0, (int)INT16_MAX);
+    }
+
+    PlayerEntry &insert(std::string_view name) {
+        uint64_t key = hash(name);
+        size_t i = key & mask;
+        for (; table[i].key; i = (i + 1) & mask) {
+            if (table[i].key == key && table[i].name == name) return table[i];
+        }
+
+        if ((count + 1) * 4 > table.size() * 3) {
+            evict();
+            return insert(name);
+        }
+
+        PlayerEntry &entry = table[i];
+        entry = PlayerEntry();
+        entry.key = key;
+        entry.name = names.store(name);
+        count++;
+        return entry;
+    }
+
+    // buang pemain dengan games < 2^b, b terkecil yang membuang minimal separuh
+    void evict() {
+        size_t histogram[33] = {};
+        for (const PlayerEntry &entry : table) {
+            if (!entry.key) continue;
+            int bucket = 0;
+            while (bucket < 32 && (entry.games >> (bucket + 1))) bucket++;
+            histogram[bucket]++;
+        }
+        int bits = 0;
+        size_t removed = 0;
+        while (bits < 32 && removed * 2 < count) removed += histogram[bits++];
+        uint64_t threshold = uint64_t(1) << bits;
+
+        StringArena kept;
+        for (PlayerEntry &entry : table) {
+            if (!entry.key) continue;
+            if (entry.games < threshold) {
+                entry.key = 0;
+                count--;
+                evictions++;
+            } else {
+                entry.name = kept.store(entry.name);
+            }
+        }
+        names = std::move(kept);
+        evicted_below = std::max<uint64_t>(evicted_below, std::min<uint64_t>(threshold, UINT32_MAX));
+
+        // rehash di tempat seperti OpeningTree::evict
+        size_t start = 0;
+        while (table[start].key) start++;
+        for (size_t n = 1; n <= mask; ++n) {
+            size_t i = (start + n) & mask;
+            if (!table[i].key) continue;
+            PlayerEntry entry = table[i];
+            table[i].key = 0;
+            size_t j = entry.key & mask;
+            while (table[j].key) j = (j + 1) & mask;
+            table[j] = entry;
+        }
+    }
+};
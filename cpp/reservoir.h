@@ -0,0 +1,70 @@
+#pragma once
+
+// Sampel seragam bottom-k dengan seed: tiap item diberi key acak dari
+// identitasnya di stream (mis. offset game di dump) dan reservoir menyimpan
+// capacity item dengan key terkecil. Key tidak bergantung pada worker atau
+// urutan item ditawarkan, jadi hasil gabungan reservoir per worker sama
+// persis untuk --threads berapa pun. Memori = kapasitas reservoir.
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// splitmix64: seed / key turunan dari satu seed. Bijektif, jadi identitas
+// berbeda dengan seed yang sama tidak pernah menghasilkan key yang sama.
+inline uint64_t mix_seed(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+template <typename T>
+class Reservoir {
+public:
+    std::vector<T> items;
+    std::vector<std::pair<uint64_t, uint32_t>> keys;  // (key, index di items), max-heap menurut key
+    uint64_t seen = 0;  // item yang sudah ditawarkan
+
+    explicit Reservoir(size_t capacity) : capacity(capacity) {}
+
+    // slot untuk item dengan key ini (ditimpa pemanggil), atau nullptr jika
+    // key-nya tidak masuk capacity terkecil. Pointer hanya valid sampai offer() berikutnya.
+    T *offer(uint64_t key) {
+        seen++;
+        if (items.size() < capacity) {
+            keys.emplace_back(key, (uint32_t)items.size());
+            std::push_heap(keys.begin(), keys.end());
+            items.emplace_back();
+            return &items.back();
+        }
+        if (capacity == 0 || key >= keys.front().first) return nullptr;
+
+        std::pop_heap(keys.begin(), keys.end());
+        keys.back().first = key;
+        uint32_t slot = keys.back().second;
+        std::push_heap(keys.begin(), keys.end());
+        return &items[slot];
+    }
+
+private:
+    size_t capacity;
+};
+
+// Gabungkan reservoir dari beberapa stream (mis. per worker): capacity item
+// dengan key terkecil dari semua reservoir = sampel bottom-k gabungan stream
+template <typename T>
+std::vector<T *> merge_reservoirs(const std::vector<Reservoir<T> *> &parts, size_t capacity) {
+    std::vector<std::pair<uint64_t, T *>> all;
+    for (Reservoir<T> *part : parts) {
+        for (const auto &key : part->keys) all.emplace_back(key.first, &part->items[key.second]);
+    }
+    size_t keep = std::min(capacity, all.size());
+    std::nth_element(all.begin(), all.begin() + keep, all.end(),
+                     [](const auto &a, const auto &b) { return a.first < b.first; });
+
+    std::vector<T *> sample;
+    for (size_t i = 0; i < keep; ++i) sample.push_back(all[i].second);
+    return sample;
+}
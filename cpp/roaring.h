@@ -0,0 +1,255 @@
+#pragma once
+
+// Roaring bitmap (Chambi, Lemire et al., 2016) tanpa run container: set
+// uint32 dibagi per 16 bit atas, tiap chunk berisi array uint16 terurut
+// (<= 4096 anggota) atau bitmap 8 KB. Dipakai untuk index game store.
+//
+// Serialisasi: uint32 jumlah container, lalu per container uint16 key,
+// uint16 tipe (0 array, 1 bitmap), uint32 kardinalitas dan isinya.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "chess_board.h"  // chess::lsb / chess::popcount
+
+class RoaringBitmap {
+public:
+    static const uint32_t ARRAY_MAX = 4096;  // di atas ini chunk disimpan sebagai bitmap
+    static const size_t BITMAP_WORDS = 65536 / 64;
+
+    // paling cepat jika x naik (game ditambahkan berurutan saat ingest)
+    void add(uint32_t x) {
+        Container &c = container((uint16_t)(x >> 16));
+        uint16_t low = (uint16_t)x;
+        if (c.is_bitmap()) {
+            uint64_t &word = c.bits[low >> 6];
+            uint64_t bit = uint64_t(1) << (low & 63);
+            if (!(word & bit)) c.cardinality++;
+            word |= bit;
+            return;
+        }
+        if (c.array.empty() || c.array.back() < low) {
+            c.array.push_back(low);
+        } else {
+            auto it = std::lower_bound(c.array.begin(), c.array.end(), low);
+            if (it != c.array.end() && *it == low) return;
+            c.array.insert(it, low);
+        }
+        c.cardinality++;
+        if (c.cardinality > ARRAY_MAX) c.to_bitmap();
+    }
+
+    bool contains(uint32_t x) const {
+        const Container *c = find((uint16_t)(x >> 16));
+        if (!c) return false;
+        uint16_t low = (uint16_t)x;
+        if (c->is_bitmap()) return (c->bits[low >> 6] >> (low & 63)) & 1;
+        return std::binary_search(c->array.begin(), c->array.end(), low);
+    }
+
+    uint64_t cardinality() const {
+        uint64_t total = 0;
+        for (const Container &c : containers) total += c.cardinality;
+        return total;
+    }
+
+    bool empty() const {
+        return containers.empty();
+    }
+
+    void union_with(const RoaringBitmap &other) {
+        std::vector<Container> merged;
+        merged.reserve(containers.size() + other.containers.size());
+        size_t i = 0, j = 0;
+        while (i < containers.size() || j < other.containers.size()) {
+            if (j == other.containers.size() || (i < containers.size() && containers[i].key < other.containers[j].key)) {
+                merged.push_back(std::move(containers[i++]));
+            } else if (i == containers.size() || other.containers[j].key < containers[i].key) {
+                merged.push_back(other.containers[j++]);
+            } else {
+                Container &a = containers[i++];
+                const Container &b = other.containers[j++];
+                if (!a.is_bitmap() && !b.is_bitmap() && a.cardinality + b.cardinality <= ARRAY_MAX) {
+                    std::vector<uint16_t> values;
+                    std::set_union(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                                   std::back_inserter(values));
+                    a.array.swap(values);
+                    a.cardinality = (uint32_t)a.array.size();
+                } else {
+                    a.to_bitmap();
+                    if (b.is_bitmap()) {
+                        for (size_t w = 0; w < BITMAP_WORDS; ++w) a.bits[w] |= b.bits[w];
+                    } else {
+                        for (uint16_t low : b.array) a.bits[low >> 6] |= uint64_t(1) << (low & 63);
+                    }
+                    a.recount();
+                    if (a.cardinality <= ARRAY_MAX) a.to_array();
+                }
+                merged.push_back(std::move(a));
+            }
+        }
+        containers.swap(merged);
+    }
+
+    void intersect_with(const RoaringBitmap &other) {
+        std::vector<Container> kept;
+        size_t j = 0;
+        for (Container &a : containers) {
+            while (j < other.containers.size() && other.containers[j].key < a.key) j++;
+            if (j == other.containers.size()) break;
+            const Container &b = other.containers[j];
+            if (b.key != a.key) continue;
+
+            if (a.is_bitmap() && b.is_bitmap()) {
+                for (size_t w = 0; w < BITMAP_WORDS; ++w) a.bits[w] &= b.bits[w];
+                a.recount();
+                if (a.cardinality <= ARRAY_MAX) a.to_array();
+            } else {
+                const Container &array = a.is_bitmap() ? b : a;
+                const Container &other_side = a.is_bitmap() ? a : b;
+                std::vector<uint16_t> values;
+                for (uint16_t low : array.array) {
+                    bool hit = other_side.is_bitmap()
+                        ? (other_side.bits[low >> 6] >> (low & 63)) & 1
+                        : std::binary_search(other_side.array.begin(), other_side.array.end(), low);
+                    if (hit) values.push_back(low);
+                }
+                a.bits.clear();
+                a.array.swap(values);
+                a.cardinality = (uint32_t)a.array.size();
+            }
+            if (a.cardinality) kept.push_back(std::move(a));
+        }
+        containers.swap(kept);
+    }
+
+    // fn(x) untuk setiap anggota, urut naik, berhenti jika fn return false
+    template <typename F>
+    void for_each(F fn) const {
+        for (const Container &c : containers) {
+            uint32_t high = (uint32_t)c.key << 16;
+            if (!c.is_bitmap()) {
+                for (uint16_t low : c.array) {
+                    if (!fn(high | low)) return;
+                }
+                continue;
+            }
+            for (size_t w = 0; w < BITMAP_WORDS; ++w) {
+                for (uint64_t word = c.bits[w]; word; word &= word - 1) {
+                    if (!fn(high | (uint32_t)(w * 64 + chess::lsb(word)))) return;
+                }
+            }
+        }
+    }
+
+    void serialize(std::string &out) const {
+        put(out, (uint32_t)containers.size());
+        for (const Container &c : containers) {
+            put(out, c.key);
+            put(out, (uint16_t)(c.is_bitmap() ? 1 : 0));
+            put(out, c.cardinality);
+            if (c.is_bitmap()) out.append((const char *)c.bits.data(), BITMAP_WORDS * sizeof(uint64_t));
+            else out.append((const char *)c.array.data(), c.array.size() * sizeof(uint16_t));
+        }
+    }
+
+    // false jika data rusak
+    bool deserialize(const char *data, size_t size) {
+        containers.clear();
+        const char *p = data, *end = data + size;
+        uint32_t count;
+        if (!get(p, end, count)) return false;
+        for (uint32_t i = 0; i < count; ++i) {
+            Container c;
+            uint16_t type;
+            if (!get(p, end, c.key) || !get(p, end, type) || !get(p, end, c.cardinality) || type > 1) return false;
+            if (!containers.empty() && containers.back().key >= c.key) return false;
+            size_t bytes = type ? BITMAP_WORDS * sizeof(uint64_t) : (size_t)c.cardinality * sizeof(uint16_t);
+            if ((size_t)(end - p) < bytes || (!type && c.cardinality > ARRAY_MAX)) return false;
+            if (type) {
+                c.bits.resize(BITMAP_WORDS);
+                memcpy(c.bits.data(), p, bytes);
+            } else {
+                c.array.resize(c.cardinality);
+                memcpy(c.array.data(), p, bytes);
+            }
+            p += bytes;
+            containers.push_back(std::move(c));
+        }
+        return true;
+    }
+
+private:
+    struct Container {
+        uint16_t key = 0;
+        uint32_t cardinality = 0;
+        std::vector<uint16_t> array;  // dipakai jika bits kosong
+        std::vector<uint64_t> bits;
+
+        bool is_bitmap() const {
+            return !bits.empty();
+        }
+
+        void to_bitmap() {
+            if (is_bitmap()) return;
+            bits.assign(BITMAP_WORDS, 0);
+            for (uint16_t low : array) bits[low >> 6] |= uint64_t(1) << (low & 63);
+            std::vector<uint16_t>().swap(array);
+        }
+
+        void to_array() {
+            array.clear();
+            for (size_t w = 0; w < BITMAP_WORDS; ++w) {
+                for (uint64_t word = bits[w]; word; word &= word - 1) {
+                    array.push_back((uint16_t)(w * 64 + chess::lsb(word)));
+                }
+            }
+            std::vector<uint64_t>().swap(bits);
+        }
+
+        void recount() {
+            cardinality = 0;
+            for (uint64_t word : bits) cardinality += (uint32_t)chess::popcount(word);
+        }
+    };
+
+    std::vector<Container> containers;  // urut menurut key
+
+    Container &container(uint16_t key) {
+        if (containers.empty() || containers.back().key < key) {
+            containers.emplace_back();
+            containers.back().key = key;
+            return containers.back();
+        }
+        auto it = std::lower_bound(containers.begin(), containers.end(), key,
+                                   [](const Container &c, uint16_t k) { return c.key < k; });
+        if (it == containers.end() || it->key != key) {
+            it = containers.insert(it, Container());
+            it->key = key;
+        }
+        return *it;
+    }
+
+    const Container *find(uint16_t key) const {
+        auto it = std::lower_bound(containers.begin(), containers.end(), key,
+                                   [](const Container &c, uint16_t k) { return c.key < k; });
+        return it != containers.end() && it->key == key ? &*it : nullptr;
+    }
+
+    template <typename T>
+    static void put(std::string &out, T value) {
+        out.append((const char *)&value, sizeof(value));
+    }
+
+    template <typename T>
+    static bool get(const char *&p, const char *end, T &value) {
+        if ((size_t)(end - p) < sizeof(T)) return false;
+        memcpy(&value, p, sizeof(T));
+        p += sizeof(T);
+        return true;
+    }
+};
@@ -0,0 +1,167 @@
+#!/usr/bin/env python3
+"""Benchmark generate_data.cpp di korpus sintetis, offline di Linux.
+
+Build generate_data + bench_generate_pgn, buat korpus .pgn.zst deterministik
+untuk tiap selektivitas filter (di-cache), jalankan generate_data beberapa
+kali per korpus lalu laporkan median games/s dan MB/s end-to-end dan per
+stage (dari baris [STATS] final di log).
+
+    python3 run_bench.py                          # 0.1%, 2%, 50%
+    python3 run_bench.py --save results.json
+    python3 run_bench.py --baseline results.json  # exit 1 jika regresi > tolerance
+"""
+
+import argparse
+import json
+import os
+import statistics
+import subprocess
+import sys
+import tempfile
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+STAGES = ["read", "decompress", "split", "scan", "parse", "write"]
+CORPUS_VERSION = 2  # naikkan jika isi korpus bench_generate_pgn berubah (2: langkah legal)
+
+
+def build(args, work):
+    flags = ["-std=c++17", "-O2", "-pthread"]
+    zstd = ["-lzstd"]
+    if args.zstd_prefix:
+        flags.append("-I" + os.path.join(args.zstd_prefix, "include"))
+        zstd = [os.path.join(args.zstd_prefix, "lib", "libzstd.a")]
+
+    binaries = {}
+    for name in ["generate_data", "bench_generate_pgn"]:
+        out = os.path.join(work, name)
+        cmd = [args.cxx, *flags, os.path.join(HERE, name + ".cpp"), *zstd, "-o", out]
+        subprocess.run(cmd, check=True)
+        binaries[name] = out
+    return binaries
+
+
+def corpus(args, binaries, keep_rate):
+    name = "bench_v%d_g%d_k%g_s%d_l%d.pgn.zst" % (CORPUS_VERSION, args.games, keep_rate, args.seed, args.level)
+    path = os.path.join(args.cache, name)
+    if not os.path.exists(path):
+        os.makedirs(args.cache, exist_ok=True)
+        tmp = path + ".tmp"
+        subprocess.run([binaries["bench_generate_pgn"], "--games", str(args.games), "--keep-rate", str(keep_rate),
+                        "--seed", str(args.seed), "--level", str(args.level), "--out", tmp],
+                       check=True, stdout=subprocess.DEVNULL)
+        os.replace(tmp, path)
+    return path
+
+
+def final_stats(log_path):
+    stats = None
+    with open(log_path) as f:
+        for line in f:
+            if "[STATS]" in line and '"event":"final"' in line:
+                stats = json.loads(line[line.index("{"):])
+    return stats
+
+
+def run_once(binaries, source, threads, work):
+    output = os.path.join(work, "out.csv")
+    log = os.path.join(work, "bench.log")
+    if os.path.exists(log):
+        os.remove(log)
+    subprocess.run([binaries["generate_data"], "--input", source, "--output", output, "--log", log,
+                    "--limit", "2000000000", "--threads", str(threads)],
+                   check=True, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    return final_stats(log)
+
+
+def summarize(runs):
+    # median per metrik, run pertama (cache dingin) tetap dihitung
+    def median(key):
+        return statistics.median(r[key] for r in runs)
+
+    stage_s = {s: statistics.median(r["stage_s"][s] for r in runs) for s in STAGES}
+    decompressed_mb = runs[0]["decompressed_mb"]
+    scanned = runs[0]["scanned"]
+    return {
+        "elapsed_s": median("elapsed_s"),
+        "scanned": scanned,
+        "kept": runs[0]["kept"],
+        "compressed_mb_s": median("compressed_mb_s"),
+        "decompressed_mb_s": median("decompressed_mb_s"),
+        "scanned_g_s": median("scanned_g_s"),
+        "kept_g_s": median("kept_g_s"),
+        "stage_s": stage_s,
+        # throughput per stage: data yang lewat dibagi waktu kerja stage itu (semua thread)
+        "stage_mb_s": {s: decompressed_mb / t if t > 0 else None for s, t in stage_s.items()},
+        "stage_g_s": {s: scanned / t if t > 0 else None for s, t in stage_s.items()},
+    }
+
+
+def print_result(key, result):
+    print("\n== %s: %d scanned, %d kept (%.2f%%), median of runs" % (
+        key, result["scanned"], result["kept"], 100.0 * result["kept"] / max(result["scanned"], 1)))
+    print("end-to-end      : %10.0f games/s  %8.1f MB/s decompressed  %7.1f MB/s compressed  %.3f s" % (
+        result["scanned_g_s"], result["decompressed_mb_s"], result["compressed_mb_s"], result["elapsed_s"]))
+    for stage in STAGES:
+        g_s, mb_s = result["stage_g_s"][stage], result["stage_mb_s"][stage]
+        if g_s is None:
+            print("  %-14s: (not measured)" % stage)
+        else:
+            print("  %-14s: %10.0f games/s  %8.1f MB/s  %7.3f s" % (stage, g_s, mb_s, result["stage_s"][stage]))
+
+
+def compare(results, baseline, tolerance):
+    failed = False
+    print("\n== regression check (tolerance %.0f%%)" % (tolerance * 100))
+    for key, result in results.items():
+        if key not in baseline:
+            print("  %-16s: no baseline" % key)
+            continue
+        before, now = baseline[key]["scanned_g_s"], result["scanned_g_s"]
+        change = (now - before) / before
+        status = "REGRESSION" if change < -tolerance else "ok"
+        failed |= status != "ok"
+        print("  %-16s: %10.0f -> %10.0f games/s (%+.1f%%) %s" % (key, before, now, change * 100, status))
+    return not failed
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--games", type=int, default=200000)
+    parser.add_argument("--keep-rates", default="0.001,0.02,0.5", help="selektivitas filter, dipisah koma")
+    parser.add_argument("--threads", default="1", help="jumlah thread generate_data, dipisah koma")
+    parser.add_argument("--runs", type=int, default=5)
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--level", type=int, default=19, help="level zstd korpus")
+    parser.add_argument("--cache", default=os.path.join(HERE, "bench_data"), help="folder korpus")
+    parser.add_argument("--cxx", default=os.environ.get("CXX", "g++"))
+    parser.add_argument("--zstd-prefix", default=os.environ.get("ZSTD_PREFIX"), help="prefix zstd (include/, lib/)")
+    parser.add_argument("--save", help="simpan hasil ke JSON")
+    parser.add_argument("--baseline", help="JSON hasil --save sebelumnya")
+    parser.add_argument("--tolerance", type=float, default=0.10, help="regresi games/s yang masih diterima")
+    args = parser.parse_args()
+
+    results = {}
+    with tempfile.TemporaryDirectory() as work:
+        binaries = build(args, work)
+        for keep_rate in [float(x) for x in args.keep_rates.split(",")]:
+            source = corpus(args, binaries, keep_rate)
+            for threads in [int(x) for x in args.threads.split(",")]:
+                key = "keep=%g%%,t=%d" % (keep_rate * 100, threads)
+                runs = [run_once(binaries, source, threads, work) for _ in range(args.runs)]
+                results[key] = summarize(runs)
+                print_result(key, results[key])
+
+    if args.save:
+        with open(args.save, "w") as f:
+            json.dump(results, f, indent=2)
+
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+        if not compare(results, baseline, args.tolerance):
+            return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
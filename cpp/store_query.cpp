@@ -0,0 +1,492 @@
+// Query game store hasil generate_data --format store lewat mmap: tanpa
+// dekompresi dan tanpa parsing PGN, hanya kolom yang dipakai filter dibaca.
+//
+// g++ -std=c++17 -O2 store_query.cpp -o store_query
+// ./store_query FILE.store                               ringkasan isi store
+// ./store_query FILE.store --game 123                    satu game (nomor urut)
+// ./store_query FILE.store --site https://lichess.org/ID satu game (link / id)
+// ./store_query FILE.store --filter "WhiteElo >= 2500 && base in [180,300]"
+//               [--count | --group-by ECO | --output FILE.csv] [--limit N]
+//
+// Filter memakai bahasa yang sama dengan generate_data --filter. Tag yang
+// tidak ada di store (mis. Variant) dianggap tidak ada di game. Konjungsi
+// pada ECO, WhiteElo / BlackElo, Date dan White / Black dijawab dulu oleh
+// index store (--no-index: selalu scan penuh).
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "csv_writer.h"
+#include "game_store.h"
+
+using namespace std;
+
+// kolom --output, langkah dalam UCI karena store tidak menyimpan SAN
+static const std::array<std::string_view, STORE_TAG_COUNT + 1> OUTPUT_COLUMNS = {
+    "event", "link", "date", "white", "black", "white_titled", "black_titled", "white_elo", "black_elo", "result",
+    "white_rating_diff", "black_rating_diff", "time_control", "termination", "eco", "opening", "moves_uci"
+};
+
+// Mengisi FilterValues langsung dari kolom store. Field dimuat per konjungsi
+// sesuai urutan FilterState, jadi game yang ditolak konjungsi pertama hanya
+// membaca kolom konjungsi itu.
+struct StoreFilter {
+    const GameStore *store = nullptr;
+    FilterState state;
+    std::vector<int> tags;                 // StoreTag per field, -1 jika tidak ada di store
+    std::vector<bool> needs_text;          // field dipakai perbandingan string
+    std::vector<std::string> text;         // teks field yang tidak ada di dictionary
+    std::vector<std::vector<int>> numbers; // angka per id dictionary
+    std::vector<std::vector<bool>> numeric;
+
+    StoreFilter(const GameStore &store, const FilterProgram &program) : store(&store), state(program) {
+        size_t n = program.fields.size();
+        tags.assign(n, -1);
+        needs_text.assign(n, false);
+        text.resize(n);
+        numbers.resize(n);
+        numeric.resize(n);
+
+        for (const FilterInstr &in : program.code) {
+            if (in.op == FilterOp::STR_EQ || in.op == FilterOp::STR_IN || in.op == FilterOp::GLOB) {
+                needs_text[in.field] = true;
+            }
+        }
+        for (size_t f = 0; f < n; ++f) {
+            tags[f] = store_tag(program.tags[program.fields[f].tag]);
+            if (tags[f] < 0 || !dict_section(STORE_TAG_SECTION[tags[f]])) continue;
+            for (std::string_view value : store.dictionary(STORE_TAG_SECTION[tags[f]])) {
+                int number = 0;
+                numeric[f].push_back(parse_int(value, 0, value.size(), number));
+                numbers[f].push_back(number);
+            }
+        }
+    }
+
+    bool accept(uint64_t game) {
+        state.reset();
+        uint64_t loaded = 0;
+        for (uint8_t c : state.order) {
+            uint64_t missing = state.program->conjuncts[c].field_mask & ~loaded;
+            for (size_t f = 0; missing; ++f, missing >>= 1) {
+                if (missing & 1) load((uint8_t)f, game);
+            }
+            loaded |= state.program->conjuncts[c].field_mask;
+            if (!state.check(false)) return false;
+        }
+        return filter_game(state);
+    }
+
+private:
+    void load(uint8_t f, uint64_t game) {
+        int tag = tags[f];
+        if (tag < 0) return;
+
+        FilterValues &values = state.values;
+        uint64_t bit = uint64_t(1) << f;
+        int section = STORE_TAG_SECTION[tag];
+        FieldSource source = state.program->fields[f].source;
+
+        if (source != FieldSource::TAG && tag == STORE_TAG_TIME_CONTROL) {
+            // base / increment dari kolom int16, teksnya TimeControl utuh
+            if (store->dict_column(section)[game] == STORE_MISSING_ID) return;
+            int16_t value = store->int16_column(source == FieldSource::TC_BASE ? SECTION_TC_BASE : SECTION_TC_INCREMENT)[game];
+            values.text[f] = store->dict_value(section, game);
+            values.number[f] = value;
+            values.seen |= bit;
+            if (value != STORE_MISSING) values.numeric |= bit;
+        } else if (dict_section(section)) {
+            uint16_t id = store->dict_column(section)[game];
+            if (id >= numbers[f].size()) return;
+            values.text[f] = store->dictionary(section)[id];
+            values.number[f] = numbers[f][id];
+            values.seen |= bit;
+            if (numeric[f][id]) values.numeric |= bit;
+        } else if (int16_section(section)) {
+            int16_t value = store->int16_column(section)[game];
+            if (value == STORE_MISSING) return;
+            if (needs_text[f]) {
+                text[f].clear();
+                store->append_tag(tag, game, text[f]);
+                values.text[f] = text[f];
+            }
+            values.number[f] = value;
+            values.seen |= bit;
+            if (value != STORE_UNKNOWN) values.numeric |= bit;
+        } else {
+            text[f].clear();
+            if (!store->append_tag(tag, game, text[f])) return;
+            int number = 0;
+            values.text[f] = text[f];
+            values.seen |= bit;
+            if (parse_int(text[f], 0, text[f].size(), number)) values.numeric |= bit;
+            values.number[f] = number;
+        }
+    }
+};
+
+// Kandidat dari index sekunder. Tiap konjungsi dievaluasi di atas bitmap:
+// daun yang bisa dijawab index menjadi bitmap game yang mungkin lolos, &&
+// mengiris, || menggabung, daun lain dan ! tidak diketahui. Hasilnya superset
+// game yang lolos (tag yang tidak ada selalu membuat daun false), jadi filter
+// tetap dicek penuh pada setiap kandidat.
+struct IndexPlan {
+    struct Set {
+        bool known = false;
+        RoaringBitmap games;
+    };
+
+    const GameStore &store;
+    const FilterProgram &program;
+    FilterValues values;
+    std::vector<std::string> used;  // tag yang dijawab index, untuk log
+
+    IndexPlan(const GameStore &store, const FilterProgram &program) : store(store), program(program) {
+        values.text.resize(program.fields.size());
+        values.number.resize(program.fields.size());
+    }
+
+    // false jika tidak ada konjungsi yang bisa dijawab index
+    bool candidates(RoaringBitmap &out) {
+        bool known = false;
+        for (const FilterConjunct &conjunct : program.conjuncts) {
+            Set set = conjunct_set(conjunct);
+            if (!set.known) continue;
+            if (known) out.intersect_with(set.games);
+            else out = std::move(set.games);
+            known = true;
+        }
+        return known;
+    }
+
+private:
+    Set conjunct_set(const FilterConjunct &conjunct) {
+        std::vector<Set> stack;
+        for (uint32_t pc = conjunct.begin; pc < conjunct.end; ++pc) {
+            FilterOp op = program.code[pc].op;
+            if (op == FilterOp::NOT) {
+                stack.back() = Set();
+            } else if (op == FilterOp::AND || op == FilterOp::OR) {
+                Set b = std::move(stack.back());
+                stack.pop_back();
+                Set &a = stack.back();
+                if (op == FilterOp::AND) {
+                    if (a.known && b.known) a.games.intersect_with(b.games);
+                    else if (b.known) a = std::move(b);
+                } else if (a.known && b.known) {
+                    a.games.union_with(b.games);
+                } else {
+                    a = Set();
+                }
+            } else {
+                stack.push_back(leaf_set(pc));
+            }
+        }
+        return std::move(stack.back());
+    }
+
+    Set leaf_set(uint32_t pc) {
+        const FilterInstr &in = program.code[pc];
+        const FilterField &field = program.fields[in.field];
+        Set set;
+        if (field.source != FieldSource::TAG) return set;
+
+        int tag = store_tag(program.tags[field.tag]);
+        bool int_op = in.op == FilterOp::INT_CMP || in.op == FilterOp::INT_RANGE || in.op == FilterOp::INT_IN;
+        int section = -1;
+        if (tag == STORE_TAG_ECO) section = SECTION_ECO_INDEX;
+        else if (tag == STORE_TAG_DATE) section = SECTION_DATE_INDEX;
+        else if (tag == STORE_TAG_WHITE_ELO && int_op) section = SECTION_WHITE_ELO_INDEX;
+        else if (tag == STORE_TAG_BLACK_ELO && int_op) section = SECTION_BLACK_ELO_INDEX;
+
+        if (tag == STORE_TAG_WHITE || tag == STORE_TAG_BLACK) {
+            // nama persis saja: index berisi hash nama
+            if (in.op == FilterOp::STR_EQ && in.cmp == FilterCmp::EQ) {
+                store.find_player(program.strings[in.a], set.games);
+            } else if (in.op == FilterOp::STR_IN) {
+                for (int i = 0; i < in.b; ++i) store.find_player(program.strings[in.a + i], set.games);
+            } else {
+                return set;
+            }
+        } else if (section >= 0) {
+            RoaringBitmap bitmap;
+            const auto &eco = store.dictionary(SECTION_ECO);
+            for (size_t i = 0; i < store.index_size(section); ++i) {
+                uint32_t key = store.index_entry(section, i).key;
+                bool match = false;
+                if (section == SECTION_ECO_INDEX) {
+                    match = key < eco.size() && leaf_matches(pc, eco[key]);
+                } else if (section == SECTION_DATE_INDEX) {
+                    char date[16];
+                    snprintf(date, sizeof(date), "%04u.%02u.%02u", key / 10000, key / 100 % 100, key % 100);
+                    match = leaf_matches(pc, date);
+                } else {
+                    for (int elo = elo_bucket_low(key); !match && elo < elo_bucket_low(key + 1); ++elo) {
+                        match = leaf_matches(pc, std::to_string(elo));
+                    }
+                }
+                if (match && store.index_bitmap(section, i, bitmap)) set.games.union_with(bitmap);
+            }
+        } else {
+            return set;
+        }
+
+        set.known = true;
+        if (std::find(used.begin(), used.end(), STORE_TAGS[tag]) == used.end()) used.emplace_back(STORE_TAGS[tag]);
+        return set;
+    }
+
+    // daun pc dicek terhadap satu nilai tag
+    bool leaf_matches(uint32_t pc, std::string_view text) {
+        const FilterInstr &in = program.code[pc];
+        int number = 0;
+        uint64_t bit = uint64_t(1) << in.field;
+        values.seen = bit;
+        values.numeric = parse_int(text, 0, text.size(), number) ? bit : 0;
+        values.text[in.field] = text;
+        values.number[in.field] = number;
+
+        FilterConjunct leaf;
+        leaf.begin = pc;
+        leaf.end = pc + 1;
+        return eval_conjunct(program, leaf, values);
+    }
+};
+
+void append_moves(const GameStore &store, uint64_t game, std::string &out) {
+    size_t n;
+    const uint16_t *moves = store.moves(game, n);
+    for (size_t i = 0; i < n; ++i) {
+        if (i) out += ' ';
+        chess::Board::append_uci(chess::Move::unpack(moves[i]), out);
+    }
+}
+
+void print_game(const GameStore &store, uint64_t game) {
+    std::string value;
+    for (int tag = 0; tag < STORE_TAG_COUNT; ++tag) {
+        value.clear();
+        if (store.append_tag(tag, game, value)) cout << "[" << STORE_TAGS[tag] << " \"" << value << "\"]\n";
+    }
+
+    size_t n;
+    const uint16_t *moves = store.moves(game, n);
+    chess::Board board;
+    for (size_t i = 0; i < n; ++i) board.make(chess::Move::unpack(moves[i]));
+    std::string fen;
+    board.append_fen(fen);
+
+    value.clear();
+    append_moves(store, game, value);
+    cout << "\nGame            : " << game << "\n"
+         << "Moves (UCI)     : " << value << "\n"
+         << "Plies           : " << n << ((store.flags()[game] & STORE_TRUNCATED) ? " (truncated at illegal SAN)" : "")
+         << ((store.flags()[game] & STORE_UNREPLAYED) ? " (movetext not replayable)" : "") << "\n"
+         << "Final FEN       : " << fen << endl;
+}
+
+void print_summary(const GameStore &store) {
+    cout << "Games           : " << store.games() << "\n"
+         << "Plies           : " << store.plies() << "\n"
+         << "File size       : " << (store.bytes() >> 20) << " MB\n";
+    for (int tag = 0; tag < STORE_TAG_COUNT; ++tag) {
+        int section = STORE_TAG_SECTION[tag];
+        if (!dict_section(section)) continue;
+        std::string label(STORE_TAGS[tag]);
+        label.resize(std::max<size_t>(label.size(), 16), ' ');
+        cout << label << ": " << store.dictionary(section).size() << " distinct values\n";
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2 || argv[1][0] == '-') {
+        cerr << "Usage: store_query FILE.store [--game N | --site URL]\n"
+                "                   [--filter EXPR] [--count | --group-by TAG | --output FILE.csv] [--limit N]\n"
+                "                   [--no-index]" << endl;
+        return 1;
+    }
+
+    fs::path path = argv[1];
+    std::string filter_text, site, group_by;
+    fs::path output;
+    int64_t game = -1;
+    bool count_only = false;
+    bool use_index = true;
+    size_t limit = SIZE_MAX;
+
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        std::string value;
+        if (arg == "--count") {
+            count_only = true;
+            continue;
+        }
+        if (arg == "--no-index") {
+            use_index = false;
+            continue;
+        }
+        size_t eq = arg.find('=');
+        if (eq != std::string::npos) {
+            value = arg.substr(eq + 1);
+            arg = arg.substr(0, eq);
+        } else if (i + 1 < argc) {
+            value = argv[++i];
+        }
+
+        int number;
+        if (arg == "--filter") {
+            filter_text = value;
+        } else if (arg == "--site") {
+            site = value;
+        } else if (arg == "--group-by") {
+            group_by = value;
+        } else if (arg == "--output") {
+            output = value;
+        } else if (arg == "--game") {
+            if (!parse_int(value, 0, value.size(), number) || number < 0) {
+                cerr << "[ERROR] Invalid --game value: " << value << endl;
+                return 1;
+            }
+            game = number;
+        } else if (arg == "--limit") {
+            if (!parse_int(value, 0, value.size(), number) || number < 1) {
+                cerr << "[ERROR] Invalid --limit value: " << value << endl;
+                return 1;
+            }
+            limit = number;
+        } else {
+            cerr << "[ERROR] Unknown option: " << arg << endl;
+            return 1;
+        }
+    }
+
+    GameStore store;
+    std::string error;
+    if (!store.open(path, error)) {
+        cerr << "[ERROR] Cannot open game store " << path << ": " << error << endl;
+        return 1;
+    }
+
+    // akses langsung satu game
+    if (!site.empty()) {
+        game = store.find_site(site);
+        if (game < 0) {
+            cerr << "[ERROR] Game not found: " << site << endl;
+            return 1;
+        }
+    }
+    if (game >= 0) {
+        if ((uint64_t)game >= store.games()) {
+            cerr << "[ERROR] Game " << game << " out of range (" << store.games() << " games)" << endl;
+            return 1;
+        }
+        print_game(store, game);
+        return 0;
+    }
+
+    if (filter_text.empty() && group_by.empty() && output.empty() && !count_only) {
+        print_summary(store);
+        return 0;
+    }
+
+    FilterProgram program;
+    if (!filter_text.empty() && !program.compile(filter_text, error)) {
+        cerr << "[ERROR] Invalid --filter: " << error << endl;
+        return 1;
+    }
+    StoreFilter filter(store, program);
+
+    int group_section = -1;
+    if (!group_by.empty()) {
+        int tag = store_tag(group_by);
+        if (tag < 0 || !dict_section(STORE_TAG_SECTION[tag])) {
+            cerr << "[ERROR] --group-by needs a dictionary tag (Event, Result, WhiteTitle, BlackTitle, TimeControl,\n"
+                    "        Termination, ECO or Opening): " << group_by << endl;
+            return 1;
+        }
+        group_section = STORE_TAG_SECTION[tag];
+    }
+
+    std::unique_ptr<CSVWriter> csv;
+    if (!output.empty()) {
+        csv = std::make_unique<CSVWriter>(output);
+        if (group_section < 0) {
+            csv->write_header(OUTPUT_COLUMNS.data(), OUTPUT_COLUMNS.size());
+        } else {
+            std::string_view names[] = { STORE_TAGS[store_tag(group_by)], "games" };
+            csv->write_header(names, 2);
+        }
+    }
+
+    // index diiris dulu, lalu hanya kandidat yang dicek filter. Tanpa index:
+    // scan kolom dengan nomor game berurutan, jadi akses memori juga berurutan
+    auto start = std::chrono::steady_clock::now();
+    RoaringBitmap candidates;
+    IndexPlan plan(store, program);
+    bool indexed = use_index && plan.candidates(candidates);
+    if (indexed) {
+        std::string tags;
+        for (const std::string &tag : plan.used) tags += (tags.empty() ? "" : ", ") + tag;
+        cerr << "[INFO] Index           : " << candidates.cardinality() << " candidates from " << tags << endl;
+    }
+
+    const uint16_t *group_column = group_section >= 0 ? store.dict_column(group_section) : nullptr;
+    std::vector<uint64_t> groups(group_section >= 0 ? store.dictionary(group_section).size() + 1 : 0);
+    std::array<std::string, OUTPUT_COLUMNS.size()> row;
+    std::array<std::string_view, OUTPUT_COLUMNS.size()> fields;
+    uint64_t matched = 0, scanned = 0;
+    auto visit = [&](uint64_t g) {
+        scanned++;
+        if (!program.conjuncts.empty() && !filter.accept(g)) return true;
+        matched++;
+
+        if (group_column) {
+            groups[std::min<size_t>(group_column[g], groups.size() - 1)]++;
+        } else if (csv && !count_only) {
+            for (int tag = 0; tag < STORE_TAG_COUNT; ++tag) {
+                row[tag].clear();
+                store.append_tag(tag, g, row[tag]);
+            }
+            row[STORE_TAG_COUNT].clear();
+            append_moves(store, g, row[STORE_TAG_COUNT]);
+            for (size_t i = 0; i < row.size(); ++i) fields[i] = row[i];
+            csv->write_row(fields.data(), fields.size());
+        }
+        return matched < limit;
+    };
+    if (indexed) {
+        candidates.for_each(visit);
+    } else {
+        for (uint64_t g = 0; g < store.games() && visit(g); ++g) {}
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (group_column) {
+        const auto &values = store.dictionary(group_section);
+        std::vector<size_t> order;
+        for (size_t id = 0; id < groups.size(); ++id) {
+            if (groups[id]) order.push_back(id);
+        }
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return groups[a] > groups[b]; });
+        for (size_t id : order) {
+            std::string count = std::to_string(groups[id]);
+            std::string_view value = id < values.size() ? values[id] : std::string_view();
+            if (csv) {
+                std::string_view fields_group[] = { value, count };
+                csv->write_row(fields_group, 2);
+            } else {
+                cout << (id < values.size() ? value : "(missing)") << "," << count << "\n";
+            }
+        }
+    }
+    if (csv) csv->flush();
+
+    cerr << "[INFO] Matched         : " << matched << " of " << scanned << " games\n"
+         << "[INFO] Scan time       : " << fixed << setprecision(2) << seconds * 1000 << " ms ("
+         << (long)(scanned / std::max(seconds, 1e-9) / 1e6) << " M games/s)" << endl;
+    if (count_only) cout << matched << endl;
+    return 0;
+}
@@ -1,13 +1,12 @@
-#include <zstd.h>
 #include <fstream>
 #include <iostream>
 #include <unordered_map>
-#include <vector>
 #include <string>
-#include <sstream>
 #include <chrono>
 #include <iomanip>
 
+#include "pgn_reader.h"
+
 using namespace std;
 
 static const long TOTAL_GAMES = 94847276;
@@ -18,24 +17,12 @@ static const string CSV_FILE = "C:/Users/gagah/Documents/Portofolios/Chess-analy
 /* ============================
    PGN HEADER PARSER
    ============================ */
-unordered_map<string, string> parse_headers(const vector<string>& lines) {
+unordered_map<string, string> parse_headers(const GameView& game) {
     unordered_map<string, string> headers;
 
-    for (const auto& line : lines) {
-        if (line.empty() || line[0] != '[') continue;
-
-        size_t key_start = 1;
-        size_t key_end = line.find(' ');
-        size_t val_start = line.find('"') + 1;
-        size_t val_end = line.rfind('"');
-
-        if (key_end == string::npos || val_start == string::npos || val_end == string::npos)
-            continue;
-
-        string key = line.substr(key_start, key_end - key_start);
-        string val = line.substr(val_start, val_end - val_start);
-        headers[key] = val;
-    }
+    game.for_each_tag([&](string_view key, string_view val) {
+        headers[string(key)] = string(val);
+    });
     return headers;
 }
 
@@ -118,9 +105,9 @@ int main() {
     cerr << "[INFO] Starting PGN parsing..." << endl;
     auto start_time = std::chrono::steady_clock::now();
 
-    ifstream file("C:/Users/gagah/Documents/Portofolios/Chess-analysis/lichess_db_standard_rated_2025-12.pgn.zst", ios::binary);
-    if (!file) {
-        cerr << "Cannot open file\n";
+    PgnStreamReader reader("C:/Users/gagah/Documents/Portofolios/Chess-analysis/lichess_db_standard_rated_2025-12.pgn.zst");
+    if (!reader.ok()) {
+        cerr << "[ERROR] " << reader.error() << endl;
         return 1;
     }
 
@@ -131,70 +118,44 @@ int main() {
                "termination,eco,opening\n";
     }
 
-    ZSTD_DStream* dstream = ZSTD_createDStream();
-    ZSTD_initDStream(dstream);
-
-    const size_t BUFSIZE = ZSTD_DStreamOutSize();
-    vector<char> inbuf(ZSTD_DStreamInSize());
-    vector<char> outbuf(BUFSIZE);
-
-    vector<string> game_lines;
-    int batch_count = 0;
     long scanned_games = 0;
     long collected = 0;
 
+    // satu GameView per game (header + movetext), bukan per blok baris kosong
+    for (const GameView &game : reader) {
+        // ===== game parsed =====
+        scanned_games++;
+
+        auto headers = parse_headers(game);
+        string row;
 
-    while (file && collected < TOTAL_CSV) {
-        file.read(inbuf.data(), inbuf.size());
-        ZSTD_inBuffer input{inbuf.data(), (size_t)file.gcount(), 0};
-
-        while (input.pos < input.size) {
-            ZSTD_outBuffer output{outbuf.data(), outbuf.size(), 0};
-            ZSTD_decompressStream(dstream, &output, &input);
-
-            string chunk(outbuf.data(), output.pos);
-            stringstream ss(chunk);
-            string line;
-
-            while (getline(ss, line)) {
-                if (line.empty() && !game_lines.empty()) {
-
-                    // ===== game parsed =====
-                    scanned_games++;
-
-                    auto headers = parse_headers(game_lines);
-                    string row;
-
-                    if (process_game(headers, row)) {
-                        csv << row << "\n";
-                        collected++;
-                    }
-
-                    // ===== tqdm-style logging =====
-                    if (scanned_games % 100000 == 0) {
-                        log_progress(
-                            scanned_games,
-                            collected,
-                            TOTAL_GAMES,
-                            start_time
-                        );
-                    }
-
-                    game_lines.clear();
-                } else {
-                    game_lines.push_back(line);
-                }
-
-                if (collected >= TOTAL_CSV) {
-                    cerr << "\n[INFO] Target CSV rows reached: "
-                        << collected << endl;
-                    break;
-                }
-            }
+        if (process_game(headers, row)) {
+            csv << row << "\n";
+            collected++;
         }
+
+        // ===== tqdm-style logging =====
+        if (scanned_games % 100000 == 0) {
+            log_progress(
+                scanned_games,
+                collected,
+                TOTAL_GAMES,
+                start_time
+            );
+        }
+
+        if (collected >= TOTAL_CSV) {
+            cerr << "\n[INFO] Target CSV rows reached: "
+                << collected << endl;
+            break;
+        }
+    }
+
+    if (!reader.ok()) {
+        cerr << "\n[ERROR] " << reader.error() << endl;
+        return 1;
     }
 
-    ZSTD_freeDStream(dstream);
     csv.close();
 
     auto end_time = std::chrono::steady_clock::now();